@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+"""Local mock of the Custom Search JSON API (customsearch/v1) for benchmarks and test/sql/web_search_mock.test.
+
+Answers web and image searches (searchType=image) with 10 generated results per page, paginated like the real
+API, with configurable latency, 5xx and 429 rates and pagemap payload size. GET /stats returns the counters.
+
+    python3 benchmark/mock_search_server.py --port 8765 --latency-ms 50 --rate-limit-rate 0.01
+    SET web_search_endpoint = 'http://127.0.0.1:8765/customsearch/v1';
+
+For the tests, some requests get a fixed answer instead:
+
+    key=quota-exceeded...    403, as for a key over its daily quota (reason dailyLimitExceeded)
+    key=access-denied...     403, as for a key of a project without the API enabled (reason accessNotConfigured)
+    q=...slow-fail-first...  the first request of each page waits SLOW_FAIL_MS, then fails with a 500
+    q=...fail-first...       the first request of each page fails with a 500
+    q=...slow-first...       the first request of each page waits SLOW_FIRST_MS, then succeeds
+    q=...duplicates...       every page after the first starts with the last 5 links of the page before (with a
+                             "Repeated" snippet)
+    q=...concurrency...      each request is held for CONCURRENCY_HOLD_MS, and every snippet is the number of these
+                             requests in flight as it is answered
+"""
+
+import argparse
+import gzip
+import json
+import random
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+RESULTS_PER_PAGE = 10
+DUPLICATES_PER_PAGE = 5
+SLOW_FAIL_MS = 300
+SLOW_FIRST_MS = 2000
+CONCURRENCY_HOLD_MS = 200
+
+
+class Stats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.requests = 0
+        self.pages = 0
+        self.errors = 0
+        self.rate_limited = 0
+        self.bytes = 0  # Response bodies before compression
+        self.bytes_sent = 0
+
+    def add(self, **counters):
+        with self.lock:
+            for name, value in counters.items():
+                setattr(self, name, getattr(self, name) + value)
+
+    def to_json(self):
+        with self.lock:
+            return {
+                "requests": self.requests,
+                "pages": self.pages,
+                "errors": self.errors,
+                "rate_limited": self.rate_limited,
+                "bytes": self.bytes,
+                "bytes_sent": self.bytes_sent,
+            }
+
+
+def make_item(query, position, image, pagemap_bytes):
+    link = "https://site%d.example.com/%s/%d" % (position % 97, query.replace(" ", "-"), position)
+    item = {
+        "kind": "customsearch#result",
+        "title": "Result %d for %s" % (position, query),
+        "htmlTitle": "Result %d for <b>%s</b>" % (position, query),
+        "link": link,
+        "displayLink": "site%d.example.com" % (position % 97),
+        "snippet": "Snippet of result %d for %s." % (position, query),
+        "htmlSnippet": "Snippet of result %d for <b>%s</b>." % (position, query),
+        "formattedUrl": link,
+        "htmlFormattedUrl": link,
+    }
+    if image:
+        item["mime"] = "image/jpeg"
+        item["image"] = {
+            "contextLink": link,
+            "height": 600,
+            "width": 800,
+            "byteSize": 48213,
+            "thumbnailLink": link + "/thumb.jpg",
+            "thumbnailHeight": 120,
+            "thumbnailWidth": 160,
+        }
+    elif pagemap_bytes > 0:
+        item["pagemap"] = {
+            "metatags": [{"og:title": item["title"], "og:description": "x" * pagemap_bytes}],
+        }
+    return item
+
+
+def make_page(query, start, image, total_results, pagemap_bytes):
+    count = max(0, min(RESULTS_PER_PAGE, total_results - (start - 1)))
+    page = {
+        "kind": "customsearch#search",
+        "searchInformation": {"totalResults": str(total_results)},
+        "queries": {"request": [{"startIndex": start, "count": count}]},
+    }
+    if count > 0:
+        positions = [start + i for i in range(count)]
+        if "duplicates" in query and start > 1:
+            # The results before this page's first, again
+            positions = [start - DUPLICATES_PER_PAGE + i if i < DUPLICATES_PER_PAGE else position
+                         for i, position in enumerate(positions)]
+        page["items"] = [make_item(query, position, image, pagemap_bytes) for position in positions]
+        for item, position in zip(page["items"], positions):
+            if position < start:
+                item["snippet"] = "Repeated result %d for %s." % (position, query)
+    next_start = start + RESULTS_PER_PAGE
+    if count == RESULTS_PER_PAGE and next_start <= min(total_results, 91):
+        page["queries"]["nextPage"] = [{"startIndex": next_start, "count": RESULTS_PER_PAGE}]
+    return page
+
+
+class MockSearchHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # Keep-alive, like the real API
+
+    def log_message(self, format, *args):
+        pass
+
+    def send_body(self, status, body, headers=(), counted=True):
+        data = body.encode("utf-8")
+        raw_size = len(data)
+        gzipped = "gzip" in self.headers.get("Accept-Encoding", "")
+        if gzipped:
+            data = gzip.compress(data, compresslevel=1)
+        if counted:
+            self.server.stats.add(bytes=raw_size, bytes_sent=len(data))
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json; charset=UTF-8")
+        self.send_header("Content-Length", str(len(data)))
+        if gzipped:
+            self.send_header("Content-Encoding", "gzip")
+        for name, value in headers:
+            self.send_header(name, value)
+        self.end_headers()
+        self.wfile.write(data)
+
+    def first_request(self, params):
+        """True for the first request of a page (query, start, search type)"""
+        page = (params.get("q"), params.get("start", "1"), params.get("searchType"))
+        with self.server.stats.lock:
+            if page in self.server.requested_pages:
+                return False
+            self.server.requested_pages.add(page)
+            return True
+
+    def send_error_status(self, status, message, reason=None):
+        self.server.stats.add(errors=1)
+        error = {"code": status, "message": message + " (mock)"}
+        if reason:
+            error["errors"] = [{"message": error["message"], "domain": "usageLimits", "reason": reason}]
+        self.send_body(status, json.dumps({"error": error}))
+
+    def do_GET(self):
+        url = urlparse(self.path)
+        if url.path == "/stats":
+            self.send_body(200, json.dumps(self.server.stats.to_json()), counted=False)
+            return
+
+        options = self.server.options
+        params = {name: values[0] for name, values in parse_qs(url.query).items()}
+        self.server.stats.add(requests=1)
+
+        query = params.get("q", "")
+        if params.get("key", "").startswith("quota-exceeded"):
+            self.send_error_status(403, "Daily Limit Exceeded", "dailyLimitExceeded")
+            return
+        if params.get("key", "").startswith("access-denied"):
+            self.send_error_status(403, "Custom Search API has not been used in project 0", "accessNotConfigured")
+            return
+        if "slow-fail-first" in query and self.first_request(params):
+            time.sleep(SLOW_FAIL_MS / 1000.0)
+            self.send_error_status(500, "Backend Error")
+            return
+        if "fail-first" in query and self.first_request(params):
+            self.send_error_status(500, "Backend Error")
+            return
+
+        in_flight = None
+        if "concurrency" in query:
+            with self.server.stats.lock:
+                self.server.concurrency_in_flight += 1
+            time.sleep(CONCURRENCY_HOLD_MS / 1000.0)
+            with self.server.stats.lock:
+                in_flight = self.server.concurrency_in_flight
+                self.server.concurrency_in_flight -= 1
+        elif "slow-first" in query and self.first_request(params):
+            time.sleep(SLOW_FIRST_MS / 1000.0)
+        else:
+            latency = options.latency_ms + random.uniform(-options.latency_jitter_ms, options.latency_jitter_ms)
+            if latency > 0:
+                time.sleep(latency / 1000.0)
+
+        roll = random.random()
+        if roll < options.rate_limit_rate:
+            self.server.stats.add(rate_limited=1)
+            error = {"error": {"code": 429, "message": "Rate Limit Exceeded (mock)"}}
+            self.send_body(429, json.dumps(error), [("Retry-After", "0")])
+            return
+        if roll < options.rate_limit_rate + options.error_rate:
+            self.server.stats.add(errors=1)
+            error = {"error": {"code": 500, "message": "Backend Error (mock)"}}
+            self.send_body(500, json.dumps(error))
+            return
+
+        if "key" not in params or "cx" not in params or "q" not in params:
+            self.send_body(400, json.dumps({"error": {"code": 400, "message": "Missing key, cx or q"}}))
+            return
+
+        start = int(params.get("start", "1"))
+        image = params.get("searchType") == "image"
+        page = make_page(params["q"], start, image, options.total_results, options.pagemap_bytes)
+        if in_flight is not None:
+            for item in page.get("items", []):
+                item["snippet"] = str(in_flight)
+        self.server.stats.add(pages=1)
+        self.send_body(200, json.dumps(page))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=0, help="0 = pick a free port")
+    parser.add_argument("--latency-ms", type=float, default=20, help="Mean response latency")
+    parser.add_argument("--latency-jitter-ms", type=float, default=5, help="Uniform spread around the mean")
+    parser.add_argument("--error-rate", type=float, default=0, help="Fraction of requests answered with a 500")
+    parser.add_argument("--rate-limit-rate", type=float, default=0, help="Fraction of requests answered with a 429")
+    parser.add_argument("--pagemap-bytes", type=int, default=512, help="Pagemap payload per web result")
+    parser.add_argument("--total-results", type=int, default=100, help="Results per query (the API caps at 100)")
+    options = parser.parse_args()
+
+    server = ThreadingHTTPServer((options.host, options.port), MockSearchHandler)
+    server.daemon_threads = True
+    server.options = options
+    server.stats = Stats()
+    server.requested_pages = set()
+    server.concurrency_in_flight = 0
+    # The benchmark runner reads the port from this line
+    print("listening on %d" % server.server_address[1], flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+"""Benchmarks of google_search(), google_search_each(), google_image_search() and the annotation COPY.
+
+Starts benchmark/mock_search_server.py, points web_search_endpoint at it and runs every benchmark in one DuckDB CLI
+process (build/release/duckdb, which has the extension linked in). Reports per benchmark:
+
+    queries/s, pages/s   queries and API pages (as served by the mock) per second of query time
+    p50, p99             query latency
+    rows/query, B/row    result rows per query, response bytes (decompressed JSON) per row - for the COPY,
+                         rows written and XML bytes per row
+    peak RSS             maximum resident set size of the DuckDB process
+
+    python3 benchmark/run_benchmark.py --iterations 20 --latency-ms 50 --rate-limit-rate 0.02
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+import urllib.request
+
+BENCHMARK_DIR = os.path.dirname(os.path.abspath(__file__))
+RUN_TIME = re.compile(r"^Run Time \(s\): real ([0-9.]+)")
+
+# name, query per iteration ({i}: iteration, distinct queries so no cache serves them)
+BENCHMARKS = [
+    # The LIMIT goes in a subquery so that it is pushed into the scan - after the count(*) it only limits its one row
+    ("google_search", "SELECT count(*) FROM (SELECT * FROM google_search('benchmark query {i}') LIMIT 100);"),
+    (
+        "google_search_projected",
+        "SELECT count(link) FROM (SELECT link FROM google_search('benchmark projected {i}') LIMIT 100);",
+    ),
+    (
+        "google_search_each",
+        "SELECT count(*) FROM google_search_each((SELECT 'benchmark each {i} ' || q FROM range(20) t(q)));",
+    ),
+    (
+        "google_image_search",
+        "SELECT count(*) FROM (SELECT * FROM google_image_search('benchmark image {i}') LIMIT 100);",
+    ),
+    (
+        "annotation_copy",
+        "COPY (SELECT '*.site' || x || '.example.com/{i}/*' AS url_pattern, 'include' AS action, "
+        "'comment ' || x AS comment FROM range({annotation_rows}) t(x)) "
+        "TO '{tmp}/annotations_{i}.xml' (FORMAT google_pse_annotation, PER_FILE true);",
+    ),
+]
+
+
+def start_mock_server(args):
+    command = [
+        sys.executable,
+        os.path.join(BENCHMARK_DIR, "mock_search_server.py"),
+        "--latency-ms",
+        str(args.latency_ms),
+        "--latency-jitter-ms",
+        str(args.latency_jitter_ms),
+        "--error-rate",
+        str(args.error_rate),
+        "--rate-limit-rate",
+        str(args.rate_limit_rate),
+        "--pagemap-bytes",
+        str(args.pagemap_bytes),
+    ]
+    server = subprocess.Popen(command, stdout=subprocess.PIPE, text=True)
+    line = server.stdout.readline()
+    match = re.match(r"listening on (\d+)", line)
+    if not match:
+        server.kill()
+        raise RuntimeError("mock server did not start: %r" % line)
+    return server, int(match.group(1))
+
+
+def mock_stats(port):
+    with urllib.request.urlopen("http://127.0.0.1:%d/stats" % port) as response:
+        return json.loads(response.read())
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    if not ordered:
+        return 0.0
+    return ordered[min(len(ordered) - 1, int(round(fraction * (len(ordered) - 1))))]
+
+
+def run_duckdb(duckdb, script):
+    """Run a script in a fresh CLI process, returns (stdout, peak RSS in bytes)"""
+    with tempfile.TemporaryFile("w+") as script_file:
+        script_file.write(script)
+        script_file.seek(0)
+        process = subprocess.Popen([duckdb, ":memory:"], stdin=script_file, stdout=subprocess.PIPE, text=True)
+        output = process.stdout.read()
+        _, status, usage = os.wait4(process.pid, 0)
+    if os.waitstatus_to_exitcode(status) != 0:
+        raise RuntimeError("duckdb failed:\n" + output)
+    # ru_maxrss is in KiB on Linux, bytes on macOS
+    peak_rss = usage.ru_maxrss if sys.platform == "darwin" else usage.ru_maxrss * 1024
+    return output, peak_rss
+
+
+def run_benchmark(args, port, name, query, tmp):
+    endpoint = "http://127.0.0.1:%d/customsearch/v1" % port
+    lines = [
+        ".mode list",
+        ".headers off",
+        "SET web_search_endpoint = '%s';" % endpoint,
+        "SET web_search_cache_mode = 'off';",
+        "SET web_search_result_cache_size = '0';",
+        "SET web_search_max_concurrency = %d;" % args.concurrency,
+        "SET web_search_initial_backoff_ms = 10;",
+        "CREATE SECRET benchmark (TYPE google_search, key 'benchmark_key', cx 'benchmark_cx');",
+        ".timer on",
+    ]
+    for i in range(args.iterations):
+        lines.append(query.format(i=i, tmp=tmp, annotation_rows=args.annotation_rows))
+
+    before = mock_stats(port)
+    output, peak_rss = run_duckdb(args.duckdb, "\n".join(lines) + "\n")
+    after = mock_stats(port)
+
+    times = []
+    rows = 0
+    for line in output.splitlines():
+        match = RUN_TIME.match(line)
+        if match:
+            times.append(float(match.group(1)))
+        elif line.strip().isdigit():
+            rows += int(line.strip())
+    # The SET and CREATE SECRET statements are timed too
+    times = times[-args.iterations :]
+    total_time = sum(times)
+    pages = after["pages"] - before["pages"]
+    response_bytes = after["bytes"] - before["bytes"]
+    if name == "annotation_copy":
+        # Bytes written instead of received
+        rows = args.annotation_rows * args.iterations
+        response_bytes = sum(os.path.getsize(os.path.join(tmp, file)) for file in os.listdir(tmp))
+    return {
+        "benchmark": name,
+        "queries_per_s": args.iterations / total_time if total_time else 0.0,
+        "pages_per_s": pages / total_time if total_time else 0.0,
+        "p50_ms": percentile(times, 0.50) * 1000,
+        "p99_ms": percentile(times, 0.99) * 1000,
+        "rows_per_query": rows / args.iterations,
+        "bytes_per_row": response_bytes / rows if rows and response_bytes else 0.0,
+        "requests": after["requests"] - before["requests"],
+        "rate_limited": after["rate_limited"] - before["rate_limited"],
+        "errors": after["errors"] - before["errors"],
+        "peak_rss_mb": peak_rss / (1024 * 1024),
+    }
+
+
+def print_results(results):
+    columns = [
+        ("benchmark", "%-24s"),
+        ("queries_per_s", "%10.2f"),
+        ("pages_per_s", "%10.1f"),
+        ("p50_ms", "%9.1f"),
+        ("p99_ms", "%9.1f"),
+        ("rows_per_query", "%10.1f"),
+        ("bytes_per_row", "%9.0f"),
+        ("requests", "%9d"),
+        ("rate_limited", "%7d"),
+        ("errors", "%7d"),
+        ("peak_rss_mb", "%9.1f"),
+    ]
+    headers = ["benchmark", "queries/s", "pages/s", "p50 ms", "p99 ms", "rows/q", "B/row", "requests", "429s",
+               "5xx", "RSS MB"]
+    widths = [len(fmt % (0 if i else "")) for i, (_, fmt) in enumerate(columns)]
+    print(" ".join(header.rjust(width) if i else header.ljust(width)
+                   for i, (header, width) in enumerate(zip(headers, widths))))
+    for result in results:
+        print(" ".join(fmt % result[column] for column, fmt in columns))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--duckdb", default="build/release/duckdb", help="DuckDB CLI with the extension")
+    parser.add_argument("--iterations", type=int, default=10, help="Queries per benchmark")
+    parser.add_argument("--concurrency", type=int, default=8, help="web_search_max_concurrency")
+    parser.add_argument("--annotation-rows", type=int, default=100000, help="Rows per annotation COPY")
+    parser.add_argument("--benchmark", action="append", help="Only run these benchmarks (repeatable)")
+    parser.add_argument("--json", help="Also write the results to this file")
+    # Mock server behaviour
+    parser.add_argument("--latency-ms", type=float, default=20)
+    parser.add_argument("--latency-jitter-ms", type=float, default=5)
+    parser.add_argument("--error-rate", type=float, default=0)
+    parser.add_argument("--rate-limit-rate", type=float, default=0)
+    parser.add_argument("--pagemap-bytes", type=int, default=512)
+    args = parser.parse_args()
+
+    if not os.path.exists(args.duckdb):
+        print("DuckDB CLI not found at %s - build it first (make release)" % args.duckdb, file=sys.stderr)
+        return 1
+
+    server, port = start_mock_server(args)
+    results = []
+    try:
+        with tempfile.TemporaryDirectory() as tmp:
+            for name, query in BENCHMARKS:
+                if args.benchmark and name not in args.benchmark:
+                    continue
+                started = time.time()
+                results.append(run_benchmark(args, port, name, query, tmp))
+                print("%s done in %.1fs" % (name, time.time() - started), file=sys.stderr)
+    finally:
+        server.terminate()
+        server.wait()
+
+    print_results(results)
+    if args.json:
+        with open(args.json, "w") as json_file:
+            json.dump(results, json_file, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+"""Runs test/sql/web_search_mock.test against benchmark/mock_search_server.py - no network access or API key needed.
+
+Starts the mock server and runs the test with WEB_SEARCH_MOCK_ENDPOINT pointing at it (without that variable, e.g.
+in make test, the test is skipped).
+
+    python3 benchmark/run_mock_tests.py --unittest build/release/test/unittest
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+BENCHMARK_DIR = os.path.dirname(os.path.abspath(__file__))
+TEST_FILE = os.path.join(os.path.dirname(BENCHMARK_DIR), "test", "sql", "web_search_mock.test")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--unittest", default="build/release/test/unittest", help="DuckDB unittest binary")
+    args = parser.parse_args()
+
+    if not os.path.exists(args.unittest):
+        print("unittest not found at %s - build it first (make release)" % args.unittest, file=sys.stderr)
+        return 1
+
+    # The hedging test needs the latency well below SLOW_FAIL_MS; no random errors
+    command = [sys.executable, os.path.join(BENCHMARK_DIR, "mock_search_server.py"), "--latency-ms", "20"]
+    server = subprocess.Popen(command, stdout=subprocess.PIPE, text=True)
+    try:
+        line = server.stdout.readline()
+        match = re.match(r"listening on (\d+)", line)
+        if not match:
+            print("mock server did not start: %r" % line, file=sys.stderr)
+            return 1
+        env = dict(os.environ)
+        env["WEB_SEARCH_MOCK_ENDPOINT"] = "http://127.0.0.1:%s/customsearch/v1" % match.group(1)
+        return subprocess.call([args.unittest, TEST_FILE], env=env)
+    finally:
+        server.kill()
+        server.wait()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,10 +1,13 @@
 #include "annotation_copy.hpp"
+#include "annotation_reader.hpp"
 #include "duckdb/function/copy_function.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
+#include <atomic>
 #include <mutex>
 #include <cstdio>
+#include <cstring>
 
 namespace duckdb {
 
@@ -12,6 +15,9 @@ namespace duckdb {
 static constexpr idx_t MAX_ANNOTATIONS = 5000;
 static constexpr idx_t MAX_FILE_SIZE_BYTES = 30 * 1024; // 30KB
 
+static constexpr const char *ANNOTATIONS_HEADER = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Annotations>\n";
+static constexpr const char *ANNOTATIONS_FOOTER = "</Annotations>\n";
+
 // Column indices
 static constexpr idx_t COL_URL_PATTERN = 0;
 static constexpr idx_t COL_ACTION = 1;
@@ -26,6 +32,7 @@ struct AnnotationCopyBindData : public FunctionData {
 	idx_t score_idx = DConstants::INVALID_INDEX;
 	bool has_comment = false;
 	bool has_score = false;
+	bool per_file = false; // PER_FILE true: roll over to name_0001.xml, name_0002.xml, ... at the limits
 
 	unique_ptr<FunctionData> Copy() const override {
 		auto result = make_uniq<AnnotationCopyBindData>();
@@ -35,53 +42,92 @@ struct AnnotationCopyBindData : public FunctionData {
 		result->score_idx = score_idx;
 		result->has_comment = has_comment;
 		result->has_score = has_score;
+		result->per_file = per_file;
 		return std::move(result);
 	}
 
 	bool Equals(const FunctionData &other) const override {
 		auto &o = other.Cast<AnnotationCopyBindData>();
 		return url_pattern_idx == o.url_pattern_idx && action_idx == o.action_idx && comment_idx == o.comment_idx &&
-		       score_idx == o.score_idx && has_comment == o.has_comment && has_score == o.has_score;
+		       score_idx == o.score_idx && has_comment == o.has_comment && has_score == o.has_score &&
+		       per_file == o.per_file;
 	}
 };
 
 // Global state
+// The lock covers the quota and the file: threads build their XML unlocked and write it in one go in Combine
 struct AnnotationCopyGlobalState : public GlobalFunctionData {
 	unique_ptr<FileHandle> handle;
 	mutex lock;
-	idx_t annotation_count = 0;
-	idx_t bytes_written = 0;
+	idx_t annotation_count = 0; // Annotations counted against MAX_ANNOTATIONS, written or not
+	idx_t bytes_written = 0;    // Bytes counted against MAX_FILE_SIZE_BYTES, written or not
+
+	// PER_FILE: each thread fills its own shard and writes it once full, shards are numbered as they are written
+	string shard_prefix; // Path without extension
+	string shard_extension;
+	std::atomic<idx_t> shard_count {0};
+};
+
+// Local state: this thread's annotations, not written yet
+// With PER_FILE this is the thread's current shard, from the XML header on
+struct AnnotationCopyLocalState : public LocalFunctionData {
+	string buffer;
+	idx_t shard_annotations = 0;
 };
 
-// Local state
-struct AnnotationCopyLocalState : public LocalFunctionData {};
-
-// XML escape special characters
-static string XmlEscape(const string &input) {
-	string result;
-	result.reserve(input.size());
-	for (char c : input) {
-		switch (c) {
-		case '&':
-			result += "&amp;";
-			break;
-		case '<':
-			result += "&lt;";
-			break;
-		case '>':
-			result += "&gt;";
-			break;
-		case '"':
-			result += "&quot;";
-			break;
-		case '\'':
-			result += "&apos;";
-			break;
-		default:
-			result += c;
+// Escape sequence of an XML special character, nullptr for any other character
+static const char *XmlEscapeSequence(char c) {
+	switch (c) {
+	case '&':
+		return "&amp;";
+	case '<':
+		return "&lt;";
+	case '>':
+		return "&gt;";
+	case '"':
+		return "&quot;";
+	case '\'':
+		return "&apos;";
+	default:
+		return nullptr;
+	}
+}
+
+// Whether any byte of the 8-byte block is an XML special character (all bytes are tested at once)
+static bool HasXmlSpecialByte(uint64_t block) {
+	static constexpr uint64_t ONES = 0x0101010101010101ULL;
+	static constexpr uint64_t LOW_BITS = 0x7F7F7F7F7F7F7F7FULL;
+	uint64_t zero_bytes = 0;
+	for (auto c : {'&', '<', '>', '"', '\''}) {
+		// Bytes equal to c are zero in y, and get their high bit set below
+		uint64_t y = block ^ (ONES * static_cast<uint8_t>(c));
+		zero_bytes |= ~(((y & LOW_BITS) + LOW_BITS) | y | LOW_BITS);
+	}
+	return zero_bytes != 0;
+}
+
+// Append data XML escaped: clean spans are skipped 8 bytes at a time and copied with a single append
+static void AppendXmlEscaped(string &out, const char *data, idx_t size) {
+	idx_t clean_start = 0;
+	idx_t pos = 0;
+	while (pos < size) {
+		if (pos + sizeof(uint64_t) <= size) {
+			uint64_t block;
+			memcpy(&block, data + pos, sizeof(block));
+			if (!HasXmlSpecialByte(block)) {
+				pos += sizeof(block);
+				continue;
+			}
+		}
+		auto escaped = XmlEscapeSequence(data[pos]);
+		if (escaped) {
+			out.append(data + clean_start, pos - clean_start);
+			out += escaped;
+			clean_start = pos + 1;
 		}
+		pos++;
 	}
-	return result;
+	out.append(data + clean_start, size - clean_start);
 }
 
 // Bind function
@@ -101,6 +147,13 @@ static unique_ptr<FunctionData> AnnotationCopyBind(ClientContext &context, CopyF
 	}
 	result->url_pattern_idx = COL_URL_PATTERN;
 
+	for (auto &option : input.info.options) {
+		if (StringUtil::Lower(option.first) == "per_file") {
+			result->per_file =
+			    option.second.empty() || option.second[0].DefaultCastAs(LogicalType::BOOLEAN).GetValue<bool>();
+		}
+	}
+
 	// Second column: action (VARCHAR - 'include' or 'exclude')
 	if (sql_types[COL_ACTION].id() != LogicalTypeId::VARCHAR) {
 		throw BinderException("Second column (action) must be VARCHAR ('include' or 'exclude')");
@@ -130,35 +183,86 @@ static unique_ptr<FunctionData> AnnotationCopyBind(ClientContext &context, CopyF
 	return std::move(result);
 }
 
+// Path of PER_FILE shard number `shard` (from 1)
+static string GetAnnotationShardPath(const AnnotationCopyGlobalState &state, idx_t shard) {
+	char suffix[32];
+	snprintf(suffix, sizeof(suffix), "_%04llu", static_cast<unsigned long long>(shard));
+	return state.shard_prefix + suffix + state.shard_extension;
+}
+
+// Once the export succeeded: remove the shards past the last one written, left by an earlier, larger PER_FILE export
+// to the same path. Shards are numbered from 1 without gaps: this stops at the first number that does not exist.
+static void RemoveStaleAnnotationShards(FileSystem &fs, const AnnotationCopyGlobalState &state) {
+	for (idx_t shard = state.shard_count + 1;; shard++) {
+		auto path = GetAnnotationShardPath(state, shard);
+		if (!fs.FileExists(path)) {
+			return;
+		}
+		fs.RemoveFile(path);
+	}
+}
+
 // Initialize global state
 static unique_ptr<GlobalFunctionData> AnnotationCopyInitializeGlobal(ClientContext &context, FunctionData &bind_data,
                                                                      const string &file_path) {
+	auto &bdata = bind_data.Cast<AnnotationCopyBindData>();
 	auto &fs = FileSystem::GetFileSystem(context);
-	auto flags = FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW;
-	auto handle = fs.OpenFile(file_path, flags);
-
 	auto result = make_uniq<AnnotationCopyGlobalState>();
-	result->handle = std::move(handle);
+
+	if (bdata.per_file) {
+		// annotations.xml -> annotations_0001.xml, annotations_0002.xml, ...
+		auto dot = file_path.find_last_of('.');
+		auto separator = file_path.find_last_of("/\\");
+		if (dot == string::npos || (separator != string::npos && dot < separator)) {
+			result->shard_prefix = file_path;
+			result->shard_extension = ".xml";
+		} else {
+			result->shard_prefix = file_path.substr(0, dot);
+			result->shard_extension = file_path.substr(dot);
+		}
+		return std::move(result);
+	}
+
+	auto flags = FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW;
+	result->handle = fs.OpenFile(file_path, flags);
 
 	// Write XML header
-	string header = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Annotations>\n";
-	result->handle->Write((void *)header.c_str(), header.size());
-	result->bytes_written = header.size();
+	result->handle->Write((void *)ANNOTATIONS_HEADER, strlen(ANNOTATIONS_HEADER));
+	result->bytes_written = strlen(ANNOTATIONS_HEADER);
 
 	return std::move(result);
 }
 
+// Write a complete shard: the buffer holds its header and annotations, the footer is added here
+static void WriteAnnotationShard(ClientContext &context, AnnotationCopyGlobalState &state, string &buffer) {
+	buffer += ANNOTATIONS_FOOTER;
+	auto path = GetAnnotationShardPath(state, ++state.shard_count);
+
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+	handle->Write((void *)buffer.data(), buffer.size());
+	handle->Close();
+}
+
 // Initialize local state
 static unique_ptr<LocalFunctionData> AnnotationCopyInitializeLocal(ExecutionContext &context, FunctionData &bind_data) {
-	return make_uniq<AnnotationCopyLocalState>();
+	auto result = make_uniq<AnnotationCopyLocalState>();
+	if (bind_data.Cast<AnnotationCopyBindData>().per_file) {
+		result->buffer = ANNOTATIONS_HEADER;
+	}
+	return std::move(result);
+}
+
+static bool IsAction(const string_t &action, const char *expected) {
+	return StringUtil::CIEquals(action.GetData(), action.GetSize(), expected, strlen(expected));
 }
 
-// Sink function - write each row
+// Sink function - append the chunk's annotations to the thread's buffer, then count them against the limits
 static void AnnotationCopySink(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
                                LocalFunctionData &lstate, DataChunk &input) {
 	auto &bdata = bind_data.Cast<AnnotationCopyBindData>();
 	auto &state = gstate.Cast<AnnotationCopyGlobalState>();
-	lock_guard<mutex> glock(state.lock);
+	auto &local = lstate.Cast<AnnotationCopyLocalState>();
 
 	// Get column data
 	UnifiedVectorFormat url_data, action_data, comment_data, score_data;
@@ -181,13 +285,10 @@ static void AnnotationCopySink(ExecutionContext &context, FunctionData &bind_dat
 		score_double.ToUnifiedFormat(input.size(), score_data);
 	}
 
+	auto &xml = local.buffer;
+	auto chunk_start = xml.size();
+	idx_t chunk_annotations = 0;
 	for (idx_t row_idx = 0; row_idx < input.size(); row_idx++) {
-		// Check annotation count limit
-		if (state.annotation_count >= MAX_ANNOTATIONS) {
-			throw InvalidInputException("Google PSE annotation limit exceeded: maximum %d annotations allowed",
-			                            MAX_ANNOTATIONS);
-		}
-
 		auto url_idx = url_data.sel->get_index(row_idx);
 		auto action_idx = action_data.sel->get_index(row_idx);
 
@@ -196,18 +297,20 @@ static void AnnotationCopySink(ExecutionContext &context, FunctionData &bind_dat
 			continue;
 		}
 
-		string url_pattern = urls[url_idx].GetString();
-		string action = StringUtil::Lower(actions[action_idx].GetString());
-
 		// Validate action
-		if (action != "include" && action != "exclude") {
-			throw InvalidInputException("Invalid action '%s'. Must be 'include' or 'exclude'", action);
+		auto &action = actions[action_idx];
+		bool include = IsAction(action, "include");
+		if (!include && !IsAction(action, "exclude")) {
+			throw InvalidInputException("Invalid action '%s'. Must be 'include' or 'exclude'",
+			                            StringUtil::Lower(action.GetString()));
 		}
 
-		string label_name = (action == "include") ? "_include_" : "_exclude_";
+		auto row_start = xml.size();
+		xml += "  <Annotation about=\"";
+		AppendXmlEscaped(xml, urls[url_idx].GetData(), urls[url_idx].GetSize());
+		xml += '"';
 
-		// Get score if present
-		string score_attr = "";
+		// Add score if present
 		if (bdata.has_score) {
 			auto score_idx_sel = score_data.sel->get_index(row_idx);
 			if (score_data.validity.RowIsValid(score_idx_sel)) {
@@ -219,58 +322,112 @@ static void AnnotationCopySink(ExecutionContext &context, FunctionData &bind_dat
 				}
 				// Format score with 1 decimal place
 				char score_buf[32];
-				snprintf(score_buf, sizeof(score_buf), "%.1f", score);
-				score_attr = " score=\"" + string(score_buf) + "\"";
+				snprintf(score_buf, sizeof(score_buf), " score=\"%.1f\"", score);
+				xml += score_buf;
 			}
 		}
 
-		// Build annotation XML
-		string xml = "  <Annotation about=\"" + XmlEscape(url_pattern) + "\"" + score_attr + ">\n";
-		xml += "    <Label name=\"" + label_name + "\"/>\n";
+		xml += include ? ">\n    <Label name=\"_include_\"/>\n" : ">\n    <Label name=\"_exclude_\"/>\n";
 
 		// Add comment if present
 		if (bdata.has_comment) {
 			auto comment_idx_sel = comment_data.sel->get_index(row_idx);
-			if (comment_data.validity.RowIsValid(comment_idx_sel)) {
-				string comment = comments[comment_idx_sel].GetString();
-				if (!comment.empty()) {
-					xml += "    <Comment>" + XmlEscape(comment) + "</Comment>\n";
-				}
+			if (comment_data.validity.RowIsValid(comment_idx_sel) && comments[comment_idx_sel].GetSize() > 0) {
+				xml += "    <Comment>";
+				AppendXmlEscaped(xml, comments[comment_idx_sel].GetData(), comments[comment_idx_sel].GetSize());
+				xml += "</Comment>\n";
 			}
 		}
 
 		xml += "  </Annotation>\n";
-
-		// Check file size limit before writing
-		if (state.bytes_written + xml.size() + 15 > MAX_FILE_SIZE_BYTES) { // 15 for closing tag
-			throw InvalidInputException("Google PSE annotation file size limit exceeded: maximum %d bytes allowed",
-			                            MAX_FILE_SIZE_BYTES);
+		chunk_annotations++;
+
+		// PER_FILE: a full shard is written and the annotation starts the next one
+		if (bdata.per_file) {
+			if (local.shard_annotations == MAX_ANNOTATIONS ||
+			    xml.size() + strlen(ANNOTATIONS_FOOTER) > MAX_FILE_SIZE_BYTES) {
+				if (local.shard_annotations == 0) {
+					throw InvalidInputException(
+					    "Google PSE annotation file size limit exceeded: annotation for '%s' is larger than %d bytes",
+					    urls[url_idx].GetString(), MAX_FILE_SIZE_BYTES);
+				}
+				string annotation = xml.substr(row_start);
+				xml.resize(row_start);
+				WriteAnnotationShard(context.client, state, xml);
+				xml = ANNOTATIONS_HEADER + annotation;
+				local.shard_annotations = 0;
+			}
+			local.shard_annotations++;
 		}
+	}
+	if (bdata.per_file) {
+		return;
+	}
 
-		state.handle->Write((void *)xml.c_str(), xml.size());
-		state.bytes_written += xml.size();
-		state.annotation_count++;
+	// Count the chunk against the limits, also for the rows other threads have not written yet
+	lock_guard<mutex> glock(state.lock);
+	if (state.annotation_count + chunk_annotations > MAX_ANNOTATIONS) {
+		throw InvalidInputException("Google PSE annotation limit exceeded: maximum %d annotations allowed",
+		                            MAX_ANNOTATIONS);
+	}
+	auto chunk_bytes = xml.size() - chunk_start;
+	if (state.bytes_written + chunk_bytes + strlen(ANNOTATIONS_FOOTER) > MAX_FILE_SIZE_BYTES) {
+		throw InvalidInputException("Google PSE annotation file size limit exceeded: maximum %d bytes allowed",
+		                            MAX_FILE_SIZE_BYTES);
 	}
+	state.annotation_count += chunk_annotations;
+	state.bytes_written += chunk_bytes;
 }
 
-// Combine function
+// Combine function - write the thread's annotations with a single write
 static void AnnotationCopyCombine(ExecutionContext &context, FunctionData &bind_data, GlobalFunctionData &gstate,
                                   LocalFunctionData &lstate) {
-	// Nothing to combine
+	auto &bdata = bind_data.Cast<AnnotationCopyBindData>();
+	auto &state = gstate.Cast<AnnotationCopyGlobalState>();
+	auto &local = lstate.Cast<AnnotationCopyLocalState>();
+	if (bdata.per_file) {
+		// The thread's last shard
+		if (local.shard_annotations > 0) {
+			WriteAnnotationShard(context.client, state, local.buffer);
+		}
+		return;
+	}
+	if (local.buffer.empty()) {
+		return;
+	}
+	lock_guard<mutex> glock(state.lock);
+	state.handle->Write((void *)local.buffer.data(), local.buffer.size());
+	local.buffer.clear();
 }
 
 // Finalize function
 static void AnnotationCopyFinalize(ClientContext &context, FunctionData &bind_data, GlobalFunctionData &gstate) {
 	auto &state = gstate.Cast<AnnotationCopyGlobalState>();
+	if (bind_data.Cast<AnnotationCopyBindData>().per_file) {
+		// An empty export is still one (empty) annotations file
+		if (state.shard_count == 0) {
+			string empty = ANNOTATIONS_HEADER;
+			WriteAnnotationShard(context, state, empty);
+		}
+		RemoveStaleAnnotationShards(FileSystem::GetFileSystem(context), state);
+		return;
+	}
 	lock_guard<mutex> glock(state.lock);
 
 	// Write closing tag
-	string footer = "</Annotations>\n";
-	state.handle->Write((void *)footer.c_str(), footer.size());
+	state.handle->Write((void *)ANNOTATIONS_FOOTER, strlen(ANNOTATIONS_FOOTER));
 
 	state.handle->Close();
 }
 
+// Without insertion order to keep, threads sink their rows in parallel (and write their own PER_FILE shards)
+static CopyFunctionExecutionMode AnnotationCopyExecutionMode(bool preserve_insertion_order, bool supports_batch_index) {
+	if (!preserve_insertion_order) {
+		return CopyFunctionExecutionMode::PARALLEL_COPY_TO_FILE;
+	}
+	return CopyFunctionExecutionMode::REGULAR_COPY_TO_FILE;
+}
+
 // Register the copy function
 void RegisterAnnotationCopyFunction(ExtensionLoader &loader) {
 	CopyFunction func("google_pse_annotation");
@@ -280,6 +437,9 @@ void RegisterAnnotationCopyFunction(ExtensionLoader &loader) {
 	func.copy_to_sink = AnnotationCopySink;
 	func.copy_to_combine = AnnotationCopyCombine;
 	func.copy_to_finalize = AnnotationCopyFinalize;
+	func.execution_mode = AnnotationCopyExecutionMode;
+	func.copy_from_bind = AnnotationCopyFromBind;
+	func.copy_from_function = GetReadPseAnnotationsFunction();
 	func.extension = "xml";
 
 	loader.RegisterFunction(func);
@@ -0,0 +1,442 @@
+#include "annotation_reader.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "utf8proc_wrapper.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace duckdb {
+
+static constexpr idx_t ANNOTATION_READ_SIZE = 64 * 1024;
+static constexpr const char *ANNOTATION_OPEN = "<Annotation";
+static constexpr const char *ANNOTATION_CLOSE = "</Annotation>";
+
+static bool IsXmlSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Append a code point as UTF-8
+static void AppendUtf8(string &out, uint32_t code_point) {
+	if (code_point < 0x80) {
+		out += static_cast<char>(code_point);
+	} else if (code_point < 0x800) {
+		out += static_cast<char>(0xC0 | (code_point >> 6));
+		out += static_cast<char>(0x80 | (code_point & 0x3F));
+	} else if (code_point < 0x10000) {
+		out += static_cast<char>(0xE0 | (code_point >> 12));
+		out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (code_point & 0x3F));
+	} else {
+		out += static_cast<char>(0xF0 | (code_point >> 18));
+		out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (code_point & 0x3F));
+	}
+}
+
+// The code point of the digits of a character reference (&#N; or &#xN;), or 0 if they are not a valid one: digits
+// only (no whitespace or sign), not NUL, not a surrogate and at most U+10FFFF
+static uint32_t ParseCharacterReference(const char *digits, idx_t size, bool hex) {
+	if (size == 0) {
+		return 0;
+	}
+	uint32_t code_point = 0;
+	for (idx_t i = 0; i < size; i++) {
+		auto c = digits[i];
+		uint32_t digit;
+		if (c >= '0' && c <= '9') {
+			digit = c - '0';
+		} else if (hex && c >= 'a' && c <= 'f') {
+			digit = c - 'a' + 10;
+		} else if (hex && c >= 'A' && c <= 'F') {
+			digit = c - 'A' + 10;
+		} else {
+			return 0;
+		}
+		code_point = code_point * (hex ? 16 : 10) + digit;
+		if (code_point > 0x10FFFF) {
+			return 0;
+		}
+	}
+	if (code_point >= 0xD800 && code_point <= 0xDFFF) {
+		return 0;
+	}
+	return code_point;
+}
+
+// Append text with the XML entities (&amp; .. &apos;, &#N; and &#xN;) replaced, unknown entities are kept as they are
+// Throws InvalidInputException for a character reference that is not a valid character
+static void AppendXmlUnescaped(string &out, const char *data, idx_t size, const string &path) {
+	static const struct {
+		const char *entity;
+		char c;
+	} ENTITIES[] = {{"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''}};
+
+	idx_t clean_start = 0;
+	for (idx_t pos = 0; pos < size; pos++) {
+		if (data[pos] != '&') {
+			continue;
+		}
+		auto semicolon = static_cast<const char *>(memchr(data + pos, ';', size - pos));
+		if (!semicolon) {
+			break;
+		}
+		idx_t length = semicolon - (data + pos) + 1;
+		string decoded;
+		if (length > 3 && data[pos + 1] == '#') {
+			bool hex = data[pos + 2] == 'x' || data[pos + 2] == 'X';
+			idx_t digits = pos + (hex ? 3 : 2);
+			auto code_point = ParseCharacterReference(data + digits, semicolon - (data + digits), hex);
+			if (code_point == 0) {
+				throw InvalidInputException("Invalid character reference \"%s\" in \"%s\"", string(data + pos, length),
+				                            path);
+			}
+			AppendUtf8(decoded, code_point);
+		} else {
+			for (auto &entity : ENTITIES) {
+				if (strlen(entity.entity) == length && memcmp(data + pos, entity.entity, length) == 0) {
+					decoded = entity.c;
+					break;
+				}
+			}
+		}
+		if (decoded.empty()) {
+			continue;
+		}
+		out.append(data + clean_start, pos - clean_start);
+		out += decoded;
+		pos += length - 1;
+		clean_start = pos + 1;
+	}
+	out.append(data + clean_start, size - clean_start);
+}
+
+// Find attribute name="value" (or 'value') in a start tag and unescape its value
+static bool GetXmlAttribute(const char *tag, idx_t size, const char *name, string &value, const string &path) {
+	idx_t name_length = strlen(name);
+	for (idx_t pos = 1; pos + name_length + 2 < size; pos++) {
+		if (!IsXmlSpace(tag[pos - 1]) || memcmp(tag + pos, name, name_length) != 0) {
+			continue;
+		}
+		idx_t eq = pos + name_length;
+		while (eq < size && IsXmlSpace(tag[eq])) {
+			eq++;
+		}
+		if (eq + 1 >= size || tag[eq] != '=') {
+			continue;
+		}
+		idx_t quote = eq + 1;
+		while (quote < size && IsXmlSpace(tag[quote])) {
+			quote++;
+		}
+		if (quote >= size || (tag[quote] != '"' && tag[quote] != '\'')) {
+			continue;
+		}
+		auto end = static_cast<const char *>(memchr(tag + quote + 1, tag[quote], size - quote - 1));
+		if (!end) {
+			return false;
+		}
+		value.clear();
+		AppendXmlUnescaped(value, tag + quote + 1, end - (tag + quote + 1), path);
+		return true;
+	}
+	return false;
+}
+
+// Position of needle in data[start, size), or size
+static idx_t FindIn(const char *data, idx_t size, idx_t start, const char *needle) {
+	idx_t needle_length = strlen(needle);
+	for (idx_t pos = start; pos + needle_length <= size; pos++) {
+		if (data[pos] == needle[0] && memcmp(data + pos, needle, needle_length) == 0) {
+			return pos;
+		}
+	}
+	return size;
+}
+
+PseAnnotationReader::PseAnnotationReader(unique_ptr<FileHandle> handle_p, string path_p)
+    : handle(std::move(handle_p)), path(std::move(path_p)) {
+}
+
+bool PseAnnotationReader::Fill() {
+	if (eof) {
+		return false;
+	}
+	// Drop what was consumed, so the buffer only ever holds the element being read
+	buffer.erase(0, pos);
+	pos = 0;
+	auto old_size = buffer.size();
+	buffer.resize(old_size + ANNOTATION_READ_SIZE);
+	auto read = handle->Read((void *)(buffer.data() + old_size), ANNOTATION_READ_SIZE);
+	buffer.resize(old_size + static_cast<idx_t>(read));
+	if (read <= 0) {
+		eof = true;
+		return false;
+	}
+	return true;
+}
+
+bool PseAnnotationReader::Next(PseAnnotation &annotation) {
+	idx_t search = pos;
+	while (true) {
+		auto start = buffer.find(ANNOTATION_OPEN, search);
+		if (start == string::npos) {
+			// Keep what could be the start of a split "<Annotation"
+			idx_t keep = strlen(ANNOTATION_OPEN);
+			if (buffer.size() > pos + keep) {
+				pos = buffer.size() - keep;
+			}
+			if (!Fill()) {
+				return false;
+			}
+			search = 0;
+			continue;
+		}
+
+		// The complete element: a self-closing start tag, or up to </Annotation>
+		idx_t name_end = start + strlen(ANNOTATION_OPEN);
+		idx_t element_end = string::npos;
+		if (name_end < buffer.size()) {
+			auto c = buffer[name_end];
+			if (!IsXmlSpace(c) && c != '>' && c != '/') {
+				// <Annotations>
+				search = name_end;
+				continue;
+			}
+			auto tag_end = buffer.find('>', name_end);
+			if (tag_end != string::npos && buffer[tag_end - 1] == '/') {
+				element_end = tag_end + 1;
+			} else if (tag_end != string::npos) {
+				auto close = buffer.find(ANNOTATION_CLOSE, tag_end);
+				if (close != string::npos) {
+					element_end = close + strlen(ANNOTATION_CLOSE);
+				}
+			}
+		}
+		if (element_end == string::npos) {
+			pos = start;
+			if (!Fill()) {
+				throw IOException("Unterminated <Annotation> element in \"%s\"", path);
+			}
+			search = 0;
+			continue;
+		}
+
+		ParseAnnotation(buffer.data() + start, element_end - start, annotation);
+		pos = element_end;
+		return true;
+	}
+}
+
+void PseAnnotationReader::ParseAnnotation(const char *data, idx_t size, PseAnnotation &annotation) {
+	idx_t tag_end = FindIn(data, size, 0, ">");
+	if (!GetXmlAttribute(data, tag_end, "about", annotation.url_pattern, path)) {
+		throw InvalidInputException("<Annotation> without an about attribute in \"%s\"", path);
+	}
+
+	string score;
+	annotation.has_score = GetXmlAttribute(data, tag_end, "score", score, path);
+	if (annotation.has_score) {
+		char *end;
+		annotation.score = strtod(score.c_str(), &end);
+		if (score.empty() || *end != '\0') {
+			throw InvalidInputException("Invalid score \"%s\" for \"%s\" in \"%s\"", score, annotation.url_pattern,
+			                            path);
+		}
+	}
+
+	// The first label is the action
+	annotation.action.clear();
+	idx_t label = FindIn(data, size, tag_end, "<Label");
+	if (label < size) {
+		idx_t label_end = FindIn(data, size, label, ">");
+		GetXmlAttribute(data + label, label_end - label, "name", annotation.action, path);
+		if (annotation.action == "_include_") {
+			annotation.action = "include";
+		} else if (annotation.action == "_exclude_") {
+			annotation.action = "exclude";
+		}
+	}
+
+	annotation.comment.clear();
+	idx_t comment = FindIn(data, size, tag_end, "<Comment>");
+	annotation.has_comment = comment < size;
+	if (annotation.has_comment) {
+		idx_t text = comment + strlen("<Comment>");
+		idx_t comment_end = FindIn(data, size, text, "</Comment>");
+		AppendXmlUnescaped(annotation.comment, data + text, comment_end - text, path);
+	}
+
+	// Raw bytes go into VARCHAR vectors as they are, so a file in another encoding (e.g. Latin-1) must not get through
+	for (auto value : {&annotation.url_pattern, &annotation.action, &annotation.comment}) {
+		if (!Utf8Proc::IsValid(value->c_str(), value->size())) {
+			throw InvalidInputException("Invalid UTF-8 in \"%s\" - annotation files must be UTF-8", path);
+		}
+	}
+}
+
+// Bind data for read_pse_annotations() and COPY FROM
+struct ReadPseAnnotationsBindData : public TableFunctionData {
+	vector<string> files;
+	// Output columns in url_pattern, action, comment, score order
+	vector<LogicalType> types;
+};
+
+struct ReadPseAnnotationsGlobalState : public GlobalTableFunctionState {
+	std::atomic<idx_t> next_file {0};
+	idx_t file_count = 0;
+
+	idx_t MaxThreads() const override {
+		return MaxValue<idx_t>(file_count, 1);
+	}
+};
+
+// Per-thread state: the file this thread is reading
+struct ReadPseAnnotationsLocalState : public LocalTableFunctionState {
+	unique_ptr<PseAnnotationReader> reader;
+	idx_t file_index = 0;
+	PseAnnotation annotation;
+};
+
+static vector<string> GlobPseAnnotationFiles(ClientContext &context, const string &path) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	vector<string> files;
+	for (auto &file : fs.GlobFiles(path, context, FileGlobOptions::DISALLOW_EMPTY)) {
+		files.push_back(file.path);
+	}
+	return files;
+}
+
+static unique_ptr<FunctionData> ReadPseAnnotationsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                       vector<LogicalType> &return_types, vector<string> &names) {
+	if (input.inputs.empty() || input.inputs[0].IsNull()) {
+		throw InvalidInputException("read_pse_annotations() requires a file path");
+	}
+	auto result = make_uniq<ReadPseAnnotationsBindData>();
+	result->files = GlobPseAnnotationFiles(context, input.inputs[0].GetValue<string>());
+
+	names = {"url_pattern", "action", "comment", "score"};
+	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::DOUBLE};
+	result->types = return_types;
+	return std::move(result);
+}
+
+unique_ptr<FunctionData> AnnotationCopyFromBind(ClientContext &context, CopyFromFunctionBindInput &input,
+                                                vector<string> &expected_names, vector<LogicalType> &expected_types) {
+	// Same columns as COPY TO, values are cast to the table's types
+	if (expected_types.size() < 2 || expected_types.size() > 4) {
+		throw BinderException("google_pse_annotation format requires 2-4 columns:\n"
+		                      "  (url_pattern VARCHAR, action VARCHAR [, comment VARCHAR] [, score DOUBLE])");
+	}
+	auto result = make_uniq<ReadPseAnnotationsBindData>();
+	result->files = GlobPseAnnotationFiles(context, input.info.file_path);
+	result->types = expected_types;
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ReadPseAnnotationsInitGlobal(ClientContext &context,
+                                                                         TableFunctionInitInput &input) {
+	auto result = make_uniq<ReadPseAnnotationsGlobalState>();
+	result->file_count = input.bind_data->Cast<ReadPseAnnotationsBindData>().files.size();
+	return std::move(result);
+}
+
+static unique_ptr<LocalTableFunctionState> ReadPseAnnotationsInitLocal(ExecutionContext &context,
+                                                                       TableFunctionInitInput &input,
+                                                                       GlobalTableFunctionState *global_state) {
+	return make_uniq<ReadPseAnnotationsLocalState>();
+}
+
+// Write a string to a column, cast if the column is not VARCHAR (COPY FROM into another type)
+static void SetAnnotationString(Vector &column, idx_t row, const string &value) {
+	if (column.GetType().id() == LogicalTypeId::VARCHAR) {
+		FlatVector::GetData<string_t>(column)[row] = StringVector::AddString(column, value);
+	} else {
+		column.SetValue(row, Value(value));
+	}
+}
+
+static void ReadPseAnnotationsScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<ReadPseAnnotationsBindData>();
+	auto &state = data.global_state->Cast<ReadPseAnnotationsGlobalState>();
+	auto &local = data.local_state->Cast<ReadPseAnnotationsLocalState>();
+	auto &annotation = local.annotation;
+
+	idx_t count = 0;
+	while (count < STANDARD_VECTOR_SIZE) {
+		if (!local.reader) {
+			// A chunk holds rows of one file only, its index is the batch index
+			if (count > 0) {
+				break;
+			}
+			local.file_index = state.next_file++;
+			if (local.file_index >= bind_data.files.size()) {
+				break;
+			}
+			auto &path = bind_data.files[local.file_index];
+			auto &fs = FileSystem::GetFileSystem(context);
+			local.reader = make_uniq<PseAnnotationReader>(fs.OpenFile(path, FileFlags::FILE_FLAGS_READ), path);
+		}
+		if (!local.reader->Next(annotation)) {
+			local.reader.reset();
+			continue;
+		}
+
+		for (idx_t col = 0; col < output.ColumnCount(); col++) {
+			auto &column = output.data[col];
+			switch (col) {
+			case 0:
+				SetAnnotationString(column, count, annotation.url_pattern);
+				break;
+			case 1:
+				if (annotation.action.empty()) {
+					FlatVector::SetNull(column, count, true);
+				} else {
+					SetAnnotationString(column, count, annotation.action);
+				}
+				break;
+			case 2:
+				if (!annotation.has_comment) {
+					FlatVector::SetNull(column, count, true);
+				} else {
+					SetAnnotationString(column, count, annotation.comment);
+				}
+				break;
+			default:
+				if (!annotation.has_score) {
+					FlatVector::SetNull(column, count, true);
+				} else if (column.GetType().id() == LogicalTypeId::DOUBLE) {
+					FlatVector::GetData<double>(column)[count] = annotation.score;
+				} else {
+					column.SetValue(count, Value::DOUBLE(annotation.score));
+				}
+				break;
+			}
+		}
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+// Files are read in index order by each thread, so insertion order is preserved across threads
+static OperatorPartitionData ReadPseAnnotationsGetPartitionData(ClientContext &context,
+                                                                TableFunctionGetPartitionInput &input) {
+	auto &local = input.local_state->Cast<ReadPseAnnotationsLocalState>();
+	return OperatorPartitionData(local.file_index);
+}
+
+TableFunction GetReadPseAnnotationsFunction() {
+	TableFunction func("read_pse_annotations", {LogicalType::VARCHAR}, ReadPseAnnotationsScan, ReadPseAnnotationsBind,
+	                   ReadPseAnnotationsInitGlobal, ReadPseAnnotationsInitLocal);
+	func.get_partition_data = ReadPseAnnotationsGetPartitionData;
+	return func;
+}
+
+void RegisterReadPseAnnotationsFunction(ExtensionLoader &loader) {
+	loader.RegisterFunction(GetReadPseAnnotationsFunction());
+}
+
+} // namespace duckdb
@@ -1,240 +1,198 @@
 #include "google_image_search_function.hpp"
 #include "google_search_secret.hpp"
 #include "http_client.hpp"
+#include "search_engine.hpp"
+#include "web_search_settings.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/optimizer/optimizer_extension.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
 #include "duckdb/planner/operator/logical_limit.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
 #include "duckdb/common/types/value.hpp"
 #include "yyjson.hpp"
-#include <mutex>
-#include <iostream>
+#include <algorithm>
 
 using namespace duckdb_yyjson;
 
 namespace duckdb {
 
 // Image search result from Google API
+// The string_t fields reference the document's strings (or are inlined), nothing is copied while parsing
 struct GoogleImageSearchResult {
-	string title;
-	string link;          // Page URL
-	string image_url;     // Direct image URL
-	string thumbnail_url; // Thumbnail URL
+	string_t title {"", 0};
+	string_t link {"", 0};          // Page URL
+	string_t image_url {"", 0};     // Direct image URL
+	string_t thumbnail_url {"", 0}; // Thumbnail URL
 	int width = 0;
 	int height = 0;
 	int thumbnail_width = 0;
 	int thumbnail_height = 0;
-	string context_link; // Page containing image
-	string mime;
-	string snippet;
+	string_t context_link {"", 0}; // Page containing image
+	string_t mime {"", 0};
+	string_t snippet {"", 0};
+	shared_ptr<SearchApiDocument> document;
 };
 
 // Bind data for google_image_search() table function
 struct GoogleImageSearchBindData : public TableFunctionData {
 	string query;
-	string api_key;
-	string cx;
-	idx_t max_results = 100; // For LIMIT pushdown
+	vector<GoogleSearchConfig> keys; // Requests are spread across several secrets (secrets := [...])
+	idx_t max_results = 100;         // For LIMIT pushdown
+	bool limit_pushed = false;
+	idx_t prefetch_pages = 0; // Pages requested concurrently (0 = sized by pushed LIMIT)
 	GoogleImageSearchFilters filters;
 };
 
-// Global state for google_image_search() table function
-struct GoogleImageSearchGlobalState : public GlobalTableFunctionState {
-	vector<GoogleImageSearchResult> results;
-	idx_t current_idx = 0;
-	int next_start = 1;
-	bool fetch_complete = false;
-	mutex state_mutex;
+using GoogleImageSearchGlobalState = SearchScanGlobalState<GoogleImageSearchResult>;
+using GoogleImageSearchLocalState = SearchScanLocalState<GoogleImageSearchResult>;
 
-	idx_t MaxThreads() const override {
-		return 1;
-	}
+// Output columns: the item field each is read from and the result member it is stored in
+struct ImageSearchColumn {
+	const char *item_field;
+	string_t GoogleImageSearchResult::*string_field;
+	int GoogleImageSearchResult::*integer_field;
+};
+
+static const ImageSearchColumn IMAGE_COLUMNS[] = {
+    {"title", &GoogleImageSearchResult::title, nullptr},
+    {"link", &GoogleImageSearchResult::link, nullptr},
+    {"link", &GoogleImageSearchResult::image_url, nullptr},
+    {"image/thumbnailLink", &GoogleImageSearchResult::thumbnail_url, nullptr},
+    {"image/width", nullptr, &GoogleImageSearchResult::width},
+    {"image/height", nullptr, &GoogleImageSearchResult::height},
+    {"image/thumbnailWidth", nullptr, &GoogleImageSearchResult::thumbnail_width},
+    {"image/thumbnailHeight", nullptr, &GoogleImageSearchResult::thumbnail_height},
+    {"image/contextLink", &GoogleImageSearchResult::context_link, nullptr},
+    {"mime", &GoogleImageSearchResult::mime, nullptr},
+    {"snippet", &GoogleImageSearchResult::snippet, nullptr}};
+static constexpr column_t IMAGE_COLUMN_COUNT = sizeof(IMAGE_COLUMNS) / sizeof(IMAGE_COLUMNS[0]);
+
+// Filter columns after the result columns: the filter value for every row, so WHERE img_size = 'large' is sent to
+// the API as imgSize=large instead of being applied to the results
+struct ImageSearchFilterColumn {
+	const char *name;
+	const char *param;
+	string GoogleImageSearchFilters::*field;
 };
 
-// Build the Google Image Search API URL
-static string BuildGoogleImageSearchUrl(const GoogleImageSearchBindData &bind_data, int start) {
-	string url = "https://www.googleapis.com/customsearch/v1";
-	url += "?key=" + UrlEncode(bind_data.api_key);
-	url += "&cx=" + UrlEncode(bind_data.cx);
-	url += "&q=" + UrlEncode(bind_data.query);
+static const ImageSearchFilterColumn IMAGE_FILTER_COLUMNS[] = {
+    {"img_size", "imgSize", &GoogleImageSearchFilters::img_size},
+    {"img_type", "imgType", &GoogleImageSearchFilters::img_type},
+    {"img_color_type", "imgColorType", &GoogleImageSearchFilters::img_color_type},
+    {"img_dominant_color", "imgDominantColor", &GoogleImageSearchFilters::img_dominant_color}};
+static constexpr column_t IMAGE_FILTER_COLUMN_COUNT = sizeof(IMAGE_FILTER_COLUMNS) / sizeof(IMAGE_FILTER_COLUMNS[0]);
+
+// Partial response field mask for the projected columns, e.g. SELECT width -> items(image/width),queries(nextPage)
+static string BuildGoogleImageSearchFieldMask(const vector<column_t> &column_ids) {
+	vector<string> item_fields;
+	for (auto column_id : column_ids) {
+		if (column_id >= IMAGE_COLUMN_COUNT) {
+			continue;
+		}
+		string field = IMAGE_COLUMNS[column_id].item_field;
+		if (std::find(item_fields.begin(), item_fields.end(), field) == item_fields.end()) {
+			item_fields.push_back(field);
+		}
+	}
+	if (item_fields.empty()) {
+		// Still needed to count the results, e.g. for count(*)
+		item_fields.push_back("link");
+	}
+	return "items(" + StringUtil::Join(item_fields, ",") + "),queries(nextPage)";
+}
+
+// Build the Google Image Search API request parameters without the key and cx (see BuildSearchKeyUrl) and start,
+// which BuildSearchPageUrl adds per page
+// fields: partial response field mask, see BuildGoogleImageSearchFieldMask
+static string BuildGoogleImageSearchUrl(const GoogleImageSearchBindData &bind_data, const string &fields) {
+	string url;
+	AppendUrlParameter(url, "q", bind_data.query);
 	url += "&searchType=image"; // Key difference: image search
 	url += "&num=10";
-	url += "&start=" + std::to_string(start);
 
 	auto &f = bind_data.filters;
 	if (!f.exact_terms.empty()) {
-		url += "&exactTerms=" + UrlEncode(f.exact_terms);
+		AppendUrlParameter(url, "exactTerms", f.exact_terms);
 	}
 	if (!f.exclude_terms.empty()) {
-		url += "&excludeTerms=" + UrlEncode(f.exclude_terms);
+		AppendUrlParameter(url, "excludeTerms", f.exclude_terms);
 	}
 	if (!f.site_search.empty()) {
-		url += "&siteSearch=" + UrlEncode(f.site_search);
+		AppendUrlParameter(url, "siteSearch", f.site_search);
 		url += "&siteSearchFilter=i";
 	}
 	if (!f.date_restrict.empty()) {
-		url += "&dateRestrict=" + UrlEncode(f.date_restrict);
+		AppendUrlParameter(url, "dateRestrict", f.date_restrict);
 	}
 	if (!f.safe.empty()) {
-		url += "&safe=" + UrlEncode(f.safe);
+		AppendUrlParameter(url, "safe", f.safe);
 	}
 	if (!f.rights.empty()) {
-		url += "&rights=" + UrlEncode(f.rights);
+		AppendUrlParameter(url, "rights", f.rights);
 	}
 
-	// Image-specific filters
-	if (!f.img_size.empty()) {
-		url += "&imgSize=" + UrlEncode(f.img_size);
-	}
-	if (!f.img_type.empty()) {
-		url += "&imgType=" + UrlEncode(f.img_type);
+	if (!f.sort.empty()) {
+		AppendUrlParameter(url, "sort", f.sort);
 	}
-	if (!f.img_color_type.empty()) {
-		url += "&imgColorType=" + UrlEncode(f.img_color_type);
-	}
-	if (!f.img_dominant_color.empty()) {
-		url += "&imgDominantColor=" + UrlEncode(f.img_dominant_color);
+
+	// Image-specific filters, from named parameters or WHERE
+	for (auto &filter_column : IMAGE_FILTER_COLUMNS) {
+		auto &value = f.*filter_column.field;
+		if (!value.empty()) {
+			AppendUrlParameter(url, filter_column.param, value);
+		}
 	}
 
 	// Request only needed fields for better performance
 	// See: https://developers.google.com/custom-search/v1/performance
-	url += "&fields=" + UrlEncode("items(title,link,snippet,mime,image),"
-	                              "queries(nextPage)");
+	AppendUrlParameter(url, "fields", fields);
 
 	return url;
 }
 
-// Parse JSON string helper
-static string GetJsonString(yyjson_val *obj, const char *key) {
-	yyjson_val *val = yyjson_obj_get(obj, key);
-	if (val && yyjson_is_str(val)) {
-		return yyjson_get_str(val);
+// Parse a single API response and append its results
+// Returns the next startIndex, or -1 if no more pages
+static int ParseGoogleImageSearchResponse(const string &response_body, vector<GoogleImageSearchResult> &results) {
+	auto document = ReadSearchApiResponse(response_body);
+	yyjson_val *items = GetSearchApiItems(*document);
+	if (!items) {
+		return -1; // No results
 	}
-	return "";
-}
 
-// Parse JSON int helper
-static int GetJsonInt(yyjson_val *obj, const char *key) {
-	yyjson_val *val = yyjson_obj_get(obj, key);
-	if (val && yyjson_is_int(val)) {
-		return static_cast<int>(yyjson_get_int(val));
-	}
-	return 0;
-}
-
-// Fetch results from Google Image Search API
-static void FetchGoogleImageSearchResults(ClientContext &context, GoogleImageSearchGlobalState &state,
-                                          const GoogleImageSearchBindData &bind_data) {
-	RetryConfig retry_config;
-
-	while (state.results.size() < bind_data.max_results && !state.fetch_complete) {
-		string url = BuildGoogleImageSearchUrl(bind_data, state.next_start);
-		auto response = HttpClient::Fetch(context, url, retry_config);
-
-		if (!response.success) {
-			if (response.status_code == 429) {
-				// Rate limited - return partial results if we have any
-				if (!state.results.empty()) {
-					std::cerr << "Google Image Search API: Rate limit exceeded (429). Returning "
-					          << state.results.size() << " results." << std::endl;
-					state.fetch_complete = true;
-					return;
-				}
-				throw InvalidInputException(
-				    "Google Search API: Rate limit exceeded. Try again later or request higher quota.");
-			} else if (response.status_code == 401) {
-				throw InvalidInputException("Google Search API: Invalid API key");
-			} else if (response.status_code == 403) {
-				throw InvalidInputException("Google Search API: Access denied or quota exceeded");
-			} else if (response.status_code == 400) {
-				throw InvalidInputException("Google Search API: Invalid request - %s", response.error);
-			}
-			throw IOException("Google Search API error: %s (status %d)", response.error, response.status_code);
+	// Process each item
+	size_t idx, max;
+	yyjson_val *item;
+	yyjson_arr_foreach(items, idx, max, item) {
+		GoogleImageSearchResult result;
+		result.title = GetJsonString(item, "title");
+		result.link = GetJsonString(item, "link");
+		result.snippet = GetJsonString(item, "snippet");
+		result.mime = GetJsonString(item, "mime");
+
+		// Get image object
+		yyjson_val *image = yyjson_obj_get(item, "image");
+		if (image) {
+			result.context_link = GetJsonString(image, "contextLink");
+			result.width = GetJsonInt(image, "width");
+			result.height = GetJsonInt(image, "height");
+			result.thumbnail_url = GetJsonString(image, "thumbnailLink");
+			result.thumbnail_width = GetJsonInt(image, "thumbnailWidth");
+			result.thumbnail_height = GetJsonInt(image, "thumbnailHeight");
 		}
 
-		// Parse JSON response
-		yyjson_doc *doc = yyjson_read(response.body.c_str(), response.body.size(), 0);
-		if (!doc) {
-			throw IOException("Failed to parse Google Search API response as JSON");
-		}
+		// The link field IS the image URL for image search
+		result.image_url = result.link;
 
-		yyjson_val *root = yyjson_doc_get_root(doc);
-
-		// Check for API error
-		yyjson_val *error = yyjson_obj_get(root, "error");
-		if (error) {
-			yyjson_val *message = yyjson_obj_get(error, "message");
-			string err_msg = message && yyjson_is_str(message) ? yyjson_get_str(message) : "Unknown error";
-			yyjson_doc_free(doc);
-			throw InvalidInputException("Google Search API error: %s", err_msg);
-		}
-
-		// Get items array
-		yyjson_val *items = yyjson_obj_get(root, "items");
-		if (!items || !yyjson_is_arr(items) || yyjson_arr_size(items) == 0) {
-			state.fetch_complete = true;
-			yyjson_doc_free(doc);
-			break;
-		}
-
-		// Process each item
-		size_t idx, max;
-		yyjson_val *item;
-		yyjson_arr_foreach(items, idx, max, item) {
-			if (state.results.size() >= bind_data.max_results) {
-				break;
-			}
-
-			GoogleImageSearchResult result;
-			result.title = GetJsonString(item, "title");
-			result.link = GetJsonString(item, "link");
-			result.snippet = GetJsonString(item, "snippet");
-			result.mime = GetJsonString(item, "mime");
-
-			// Get image object
-			yyjson_val *image = yyjson_obj_get(item, "image");
-			if (image) {
-				result.context_link = GetJsonString(image, "contextLink");
-				result.width = GetJsonInt(image, "width");
-				result.height = GetJsonInt(image, "height");
-				result.thumbnail_url = GetJsonString(image, "thumbnailLink");
-				result.thumbnail_width = GetJsonInt(image, "thumbnailWidth");
-				result.thumbnail_height = GetJsonInt(image, "thumbnailHeight");
-			}
-
-			// The link field IS the image URL for image search
-			result.image_url = result.link;
-
-			state.results.push_back(result);
-		}
-
-		// Check for next page and extract startIndex
-		yyjson_val *queries = yyjson_obj_get(root, "queries");
-		if (queries) {
-			yyjson_val *next_page = yyjson_obj_get(queries, "nextPage");
-			if (next_page && yyjson_is_arr(next_page) && yyjson_arr_size(next_page) > 0) {
-				yyjson_val *next_page_obj = yyjson_arr_get_first(next_page);
-				if (next_page_obj) {
-					yyjson_val *start_index = yyjson_obj_get(next_page_obj, "startIndex");
-					if (start_index && yyjson_is_int(start_index)) {
-						state.next_start = static_cast<int>(yyjson_get_int(start_index));
-					} else {
-						state.fetch_complete = true;
-					}
-				} else {
-					state.fetch_complete = true;
-				}
-			} else {
-				state.fetch_complete = true;
-			}
-		} else {
-			state.fetch_complete = true;
-		}
-
-		yyjson_doc_free(doc);
+		result.document = document;
+		document->result_count++;
+		results.push_back(std::move(result));
 	}
+
+	return GetSearchApiNextStart(*document);
 }
 
 // Bind function
@@ -248,9 +206,7 @@ static unique_ptr<FunctionData> GoogleImageSearchBind(ClientContext &context, Ta
 	bind_data->query = input.inputs[0].GetValue<string>();
 
 	// Get API credentials from secret
-	auto config = GetGoogleSearchConfigFromSecret(context);
-	bind_data->api_key = config.api_key;
-	bind_data->cx = config.cx;
+	bind_data->keys = GetGoogleSearchConfigsFromSecrets(context, input.named_parameters);
 
 	// Parse named parameters
 	for (auto &kv : input.named_parameters) {
@@ -277,6 +233,14 @@ static unique_ptr<FunctionData> GoogleImageSearchBind(ClientContext &context, Ta
 			bind_data->filters.img_color_type = value;
 		} else if (key == "img_dominant_color") {
 			bind_data->filters.img_dominant_color = value;
+		} else if (key == "sort") {
+			bind_data->filters.sort = value;
+		} else if (key == "prefetch_pages") {
+			auto pages = kv.second.GetValue<int64_t>();
+			if (pages < 0) {
+				throw InvalidInputException("google_image_search: prefetch_pages must be >= 0 (0 = automatic)");
+			}
+			bind_data->prefetch_pages = static_cast<idx_t>(pages);
 		}
 	}
 
@@ -305,49 +269,135 @@ static unique_ptr<FunctionData> GoogleImageSearchBind(ClientContext &context, Ta
 	return_types.emplace_back(LogicalType::VARCHAR); // mime
 	return_types.emplace_back(LogicalType::VARCHAR); // snippet
 
+	// Filter columns for WHERE pushdown, and date for ORDER BY pushdown
+	for (auto &filter_column : IMAGE_FILTER_COLUMNS) {
+		names.emplace_back(filter_column.name);
+		return_types.emplace_back(LogicalType::VARCHAR);
+	}
+	names.emplace_back("date");
+	return_types.emplace_back(LogicalType::VARCHAR);
+
 	return std::move(bind_data);
 }
 
 // Global init function
 static unique_ptr<GlobalTableFunctionState> GoogleImageSearchInitGlobal(ClientContext &context,
                                                                         TableFunctionInitInput &input) {
-	auto state = make_uniq<GoogleImageSearchGlobalState>();
 	auto &bind_data = input.bind_data->Cast<GoogleImageSearchBindData>();
 
-	FetchGoogleImageSearchResults(context, *state, bind_data);
-
+	// Only request the fields of the projected columns
+	auto fields = BuildGoogleImageSearchFieldMask(input.column_ids);
+
+	// The filters are final once the pushdowns ran, so the URL is built once here
+	auto url = BuildGoogleImageSearchUrl(bind_data, fields);
+	auto key_urls = BuildSearchKeyUrls(context, bind_data.keys);
+	auto cache_key = ResultCacheKey(key_urls[0] + url, bind_data.max_results);
+	idx_t window = GetSearchPageWindow(bind_data.prefetch_pages, bind_data.limit_pushed);
+	auto state = InitSearchScanState<GoogleImageSearchGlobalState, GoogleImageSearchResult>(
+	    context, input.column_ids, std::move(fields), std::move(cache_key), 1, bind_data.max_results, window);
+	state->key_urls = std::move(key_urls);
+	state->stream_urls.push_back(std::move(url));
 	return std::move(state);
 }
 
+// Writer for one output column - no copy, the strings stay in the response documents
+static void WriteImageStringColumn(Vector &column, const vector<GoogleImageSearchResult> &results, idx_t start,
+                                   idx_t count, string_t GoogleImageSearchResult::*field) {
+	auto data = FlatVector::GetData<string_t>(column);
+	for (idx_t row = 0; row < count; row++) {
+		data[row] = results[start + row].*field;
+	}
+	AttachSearchApiDocuments(column, results, start, count);
+}
+
+// Write results[start, start + count) of the projected columns straight into the output vectors
+static void WriteGoogleImageSearchRows(DataChunk &output, const vector<column_t> &column_ids,
+                                       const vector<GoogleImageSearchResult> &results, idx_t start, idx_t count,
+                                       const GoogleImageSearchBindData &bind_data) {
+	for (idx_t col = 0; col < column_ids.size(); col++) {
+		auto &column = output.data[col];
+		if (column_ids[col] >= IMAGE_COLUMN_COUNT) {
+			// Filter columns return the filter value, date and row id are NULL
+			auto filter_idx = column_ids[col] - IMAGE_COLUMN_COUNT;
+			SetSearchFilterColumn(column, filter_idx < IMAGE_FILTER_COLUMN_COUNT
+			                                  ? bind_data.filters.*IMAGE_FILTER_COLUMNS[filter_idx].field
+			                                  : string());
+			continue;
+		}
+		auto &image_column = IMAGE_COLUMNS[column_ids[col]];
+		if (image_column.string_field) {
+			WriteImageStringColumn(column, results, start, count, image_column.string_field);
+			continue;
+		}
+		auto data = FlatVector::GetData<int32_t>(column);
+		for (idx_t row = 0; row < count; row++) {
+			data[row] = results[start + row].*image_column.integer_field;
+		}
+	}
+}
+
 // Scan function
 static void GoogleImageSearchScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
 	auto &state = data.global_state->Cast<GoogleImageSearchGlobalState>();
+	auto &local = data.local_state->Cast<GoogleImageSearchLocalState>();
+	auto &bind_data = data.bind_data->Cast<GoogleImageSearchBindData>();
 
-	idx_t count = 0;
-	idx_t max_count = STANDARD_VECTOR_SIZE;
-
-	while (count < max_count && state.current_idx < state.results.size()) {
-		auto &result = state.results[state.current_idx];
-
-		output.SetValue(0, count, Value(result.title));
-		output.SetValue(1, count, Value(result.link));
-		output.SetValue(2, count, Value(result.image_url));
-		output.SetValue(3, count, Value(result.thumbnail_url));
-		output.SetValue(4, count, Value::INTEGER(result.width));
-		output.SetValue(5, count, Value::INTEGER(result.height));
-		output.SetValue(6, count, Value::INTEGER(result.thumbnail_width));
-		output.SetValue(7, count, Value::INTEGER(result.thumbnail_height));
-		output.SetValue(8, count, Value(result.context_link));
-		output.SetValue(9, count, Value(result.mime));
-		output.SetValue(10, count, Value(result.snippet));
-
-		state.current_idx++;
-		count++;
+	auto build_url = [&](const SearchPageUnit &unit) { return BuildSearchPageUrl(context, state, unit); };
+	if (!SearchScanNextRows(context, state, local, build_url, ParseGoogleImageSearchResponse)) {
+		output.SetCardinality(0);
+		return;
 	}
 
+	auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, local.results.size() - local.current_idx);
+	WriteGoogleImageSearchRows(output, state.column_ids, local.results, local.current_idx, count, bind_data);
+	local.current_idx += count;
 	output.SetCardinality(count);
 }
 
+// Filter pushdown: img_size = 'large' etc. become API parameters
+static void GoogleImageSearchPushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                                   vector<unique_ptr<Expression>> &filters) {
+	auto &bind_data = bind_data_p->Cast<GoogleImageSearchBindData>();
+
+	vector<idx_t> filters_to_remove;
+	for (idx_t i = 0; i < filters.size(); i++) {
+		auto &filter = filters[i];
+		if (filter->type != ExpressionType::COMPARE_EQUAL ||
+		    filter->GetExpressionClass() != ExpressionClass::BOUND_COMPARISON) {
+			continue;
+		}
+		auto &comparison = filter->Cast<BoundComparisonExpression>();
+		if (comparison.left->GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF ||
+		    comparison.right->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+			continue;
+		}
+		auto &col_ref = comparison.left->Cast<BoundColumnRefExpression>();
+		auto &constant = comparison.right->Cast<BoundConstantExpression>();
+		if (constant.value.IsNull() || constant.value.type().id() != LogicalTypeId::VARCHAR) {
+			continue;
+		}
+
+		for (auto &filter_column : IMAGE_FILTER_COLUMNS) {
+			if (col_ref.GetName() != filter_column.name) {
+				continue;
+			}
+			// A different value from a named parameter stays a filter (and returns no rows)
+			auto &value = bind_data.filters.*filter_column.field;
+			auto pushed = constant.value.ToString();
+			if (value.empty() || value == pushed) {
+				value = pushed;
+				filters_to_remove.push_back(i);
+			}
+			break;
+		}
+	}
+
+	// Remove pushed down filters (iterate in reverse to preserve indices)
+	for (auto it = filters_to_remove.rbegin(); it != filters_to_remove.rend(); ++it) {
+		filters.erase(filters.begin() + *it);
+	}
+}
+
 // LIMIT pushdown optimizer
 void OptimizeGoogleImageSearchLimitPushdown(unique_ptr<LogicalOperator> &op) {
 	if (op->type == LogicalOperatorType::LOGICAL_LIMIT) {
@@ -382,6 +432,7 @@ void OptimizeGoogleImageSearchLimitPushdown(unique_ptr<LogicalOperator> &op) {
 		if (limit.limit_val.Type() == LimitNodeType::CONSTANT_VALUE) {
 			auto limit_value = limit.limit_val.GetConstantValue();
 			bind_data.max_results = std::min(limit_value, (idx_t)100);
+			bind_data.limit_pushed = true;
 		}
 		return;
 	}
@@ -391,10 +442,42 @@ void OptimizeGoogleImageSearchLimitPushdown(unique_ptr<LogicalOperator> &op) {
 	}
 }
 
+// ORDER BY pushdown optimizer - converts ORDER BY date to API sort parameter
+void OptimizeGoogleImageSearchOrderByPushdown(unique_ptr<LogicalOperator> &op) {
+	string sort_param;
+	auto get = MatchSearchOrderByDate(*op, "google_image_search", sort_param);
+	if (get) {
+		// Set the sort parameter (only if not already set via named param)
+		auto &bind_data = get->bind_data->Cast<GoogleImageSearchBindData>();
+		if (bind_data.filters.sort.empty()) {
+			bind_data.filters.sort = sort_param;
+		}
+		return;
+	}
+
+	for (auto &child : op->children) {
+		OptimizeGoogleImageSearchOrderByPushdown(child);
+	}
+}
+
+// A single query returns at most 100 results
+static unique_ptr<NodeStatistics> GoogleImageSearchCardinality(ClientContext &context,
+                                                               const FunctionData *bind_data_p) {
+	auto &bind_data = bind_data_p->Cast<GoogleImageSearchBindData>();
+	auto results = MinValue<idx_t>(bind_data.max_results, SEARCH_RESULTS_PER_PAGE * SEARCH_MAX_PAGES);
+	return make_uniq<NodeStatistics>(results, results);
+}
+
 // Register the table function
 void RegisterGoogleImageSearchFunction(ExtensionLoader &loader) {
 	TableFunction func("google_image_search", {LogicalType::VARCHAR}, GoogleImageSearchScan, GoogleImageSearchBind,
-	                   GoogleImageSearchInitGlobal);
+	                   GoogleImageSearchInitGlobal, SearchScanInitLocal<GoogleImageSearchResult>);
+	func.get_partition_data = SearchScanGetPartitionData<GoogleImageSearchResult>;
+	func.pushdown_complex_filter = GoogleImageSearchPushdownComplexFilter;
+	func.projection_pushdown = true;
+	func.cardinality = GoogleImageSearchCardinality;
+	func.table_scan_progress = SearchScanProgress<GoogleImageSearchResult>;
+	func.dynamic_to_string = SearchScanDynamicToString<GoogleImageSearchResult>;
 
 	// Named parameters for filter pushdown
 	func.named_parameters["exact_terms"] = LogicalType::VARCHAR;
@@ -403,6 +486,10 @@ void RegisterGoogleImageSearchFunction(ExtensionLoader &loader) {
 	func.named_parameters["date_restrict"] = LogicalType::VARCHAR;
 	func.named_parameters["safe"] = LogicalType::BOOLEAN;
 	func.named_parameters["rights"] = LogicalType::VARCHAR;
+	func.named_parameters["sort"] = LogicalType::VARCHAR;
+	func.named_parameters["prefetch_pages"] = LogicalType::INTEGER;
+	func.named_parameters["secret"] = LogicalType::VARCHAR;
+	func.named_parameters["secrets"] = LogicalType::LIST(LogicalType::VARCHAR);
 
 	// Image-specific parameters
 	func.named_parameters["img_size"] = LogicalType::VARCHAR;
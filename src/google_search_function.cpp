@@ -1,13 +1,23 @@
 #include "google_search_function.hpp"
 #include "google_search_secret.hpp"
 #include "http_client.hpp"
+#include "link_hash_set.hpp"
+#include "rate_limiter.hpp"
+#include "search_engine.hpp"
+#include "search_plan.hpp"
+#include "web_search_settings.hpp"
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/table/scan_state.hpp"
+#include "duckdb/transaction/duck_transaction.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/optimizer/optimizer_extension.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
 #include "duckdb/planner/operator/logical_limit.hpp"
-#include "duckdb/planner/operator/logical_order.hpp"
 #include "duckdb/planner/expression/bound_comparison_expression.hpp"
 #include "duckdb/planner/expression/bound_constant_expression.hpp"
 #include "duckdb/planner/expression/bound_columnref_expression.hpp"
@@ -17,39 +27,46 @@
 #include "duckdb/common/types/value.hpp"
 #include "duckdb/common/types/timestamp.hpp"
 #include "yyjson.hpp"
+#include <algorithm>
+#include <map>
 #include <mutex>
 #include <ctime>
 #include <sstream>
 #include <iomanip>
-#include <iostream>
 
 using namespace duckdb_yyjson;
 
 namespace duckdb {
 
 // Search result from Google API
+// The string_t fields reference the document's strings (or are inlined), nothing is copied while parsing
 struct GoogleSearchResult {
-	string title;
-	string link;
-	string snippet;
-	string display_link;
-	string formatted_url;
-	string html_formatted_url;
-	string html_title;
-	string html_snippet;
-	string mime;
-	string file_format;
-	string pagemap; // JSON string
-	string site;    // Extracted from link for filtering
-	string date;    // Page date (for ORDER BY pushdown)
+	string_t title {"", 0};
+	string_t link {"", 0};
+	string_t snippet {"", 0};
+	string_t display_link {"", 0};
+	string_t formatted_url {"", 0};
+	string_t html_formatted_url {"", 0};
+	string_t html_title {"", 0};
+	string_t html_snippet {"", 0};
+	string_t mime {"", 0};
+	string_t file_format {"", 0};
+	yyjson_val *pagemap = nullptr; // Structured data object, written as JSON or MAP
+	string_t site {"", 0};         // Extracted from link for filtering
+	string_t date {"", 0};  // Page date (for ORDER BY pushdown)
+	shared_ptr<SearchApiDocument> document;
 };
 
 // Bind data for google_search() table function
 struct GoogleSearchBindData : public TableFunctionData {
 	string query;
-	string api_key;
-	string cx;
-	idx_t max_results = 100; // For LIMIT pushdown (Google max is 100)
+	vector<GoogleSearchConfig> keys; // Requests are spread across several secrets (secrets := [...])
+	idx_t max_results = 100;         // For LIMIT pushdown (Google max is 100)
+	bool limit_pushed = false;
+	idx_t prefetch_pages = 0;   // Pages requested concurrently per round trip (0 = sized by pushed LIMIT)
+	bool pagemap_as_map = false; // pagemap_format := 'map'
+	bool dedupe = false;         // dedupe := true, drop results with a link returned before
+	string since_table;          // since_table := 'name', drop results with a link in the table's link column
 
 	// Columns for output schema
 	vector<string> column_names;
@@ -75,45 +92,42 @@ struct GoogleSearchBindData : public TableFunctionData {
 	GoogleSearchFilters filters;
 };
 
-// Per-site pagination state
-struct SitePaginationState {
-	int next_start = 1;
-	bool exhausted = false;
-};
-
 // Global state for google_search() table function
-struct GoogleSearchGlobalState : public GlobalTableFunctionState {
-	vector<GoogleSearchResult> results;
-	idx_t current_idx = 0;
+struct GoogleSearchGlobalState : public SearchScanGlobalState<GoogleSearchResult> {
+	GoogleSearchGlobalState(idx_t stream_count, idx_t max_results, idx_t window)
+	    : SearchScanGlobalState<GoogleSearchResult>(stream_count, max_results, window) {
+	}
 
-	// For multi-site queries: track pagination per site
-	vector<SitePaginationState> site_states;
-	idx_t current_site_idx = 0;
+	// One result stream per query of the plan
+	SearchSitePlan plan;
 
-	// For single query (no site filter)
-	int next_start = 1;
-	bool fetch_complete = false;
+	// dedupe := true: links returned so far, across pages and queries. Only used by the single scan thread.
+	LinkHashSet seen_links;
+	// since_table := '...': links of earlier runs, read once per scan
+	shared_ptr<const LinkHashSet> known_links;
+};
 
-	mutex state_mutex;
+// Extract domain from URL - a view into the URL
+static string_t ExtractDomain(const string_t &url) {
+	auto data = url.GetData();
+	auto size = url.GetSize();
 
-	idx_t MaxThreads() const override {
-		return 1; // Single-threaded for HTTP fetching
+	// Skip past ://
+	idx_t start = 0;
+	for (idx_t i = 0; i + 2 < size; i++) {
+		if (data[i] == ':' && data[i + 1] == '/' && data[i + 2] == '/') {
+			start = i + 3;
+			break;
+		}
 	}
-};
-
-// Extract domain from URL
-static string ExtractDomain(const string &url) {
-	// Find ://
-	size_t protocol_end = url.find("://");
-	size_t start = (protocol_end != string::npos) ? protocol_end + 3 : 0;
 
 	// Find end of domain (first / or end of string)
-	size_t end = url.find('/', start);
-	if (end == string::npos) {
-		end = url.length();
+	idx_t end = start;
+	while (end < size && data[end] != '/') {
+		end++;
 	}
 
-	return url.substr(start, end - start);
+	return string_t(data + start, UnsafeNumericCast<uint32_t>(end - start));
 }
 
 // Convert timestamp to Google dateRestrict format
@@ -146,16 +160,57 @@ static string TimestampToDateRestrict(timestamp_t from_ts, timestamp_t to_ts) {
 	}
 }
 
-// Build the Google Search API URL
-// site_filter: single site for siteSearch param (used when LIMIT > 100)
-// use_or_sites: if true, add all site_includes as (site:a OR site:b) to query (used when LIMIT <= 100)
-static string BuildGoogleSearchUrl(const GoogleSearchBindData &bind_data, int start, const string &site_filter = "",
-                                   bool use_or_sites = false) {
-	string url = "https://www.googleapis.com/customsearch/v1";
-	url += "?key=" + UrlEncode(bind_data.api_key);
-	url += "&cx=" + UrlEncode(bind_data.cx);
+// Output columns with a fixed position (see BindGoogleSearchColumns)
+static constexpr column_t LINK_COLUMN = 1;
+static constexpr column_t PAGEMAP_COLUMN = 10;
+static constexpr column_t SITE_COLUMN = 11;
+static constexpr column_t DATE_COLUMN = 12;
+static constexpr column_t LANGUAGE_COLUMN = 13;
+static constexpr column_t COUNTRY_COLUMN = 14;
+static constexpr column_t FILE_TYPE_COLUMN = 15;
+static constexpr column_t TERM_COLUMN = 16;
+static constexpr column_t EXACT_MATCH_COLUMN = 17;
+static constexpr column_t GOOGLE_SEARCH_COLUMN_COUNT = 18;
+
+// API item field each output column is read from (nullptr: not read from the response)
+static const char *const GOOGLE_SEARCH_ITEM_FIELDS[GOOGLE_SEARCH_COLUMN_COUNT] = {
+    "title",      "link",        "snippet", "displayLink", "formattedUrl", "htmlFormattedUrl",
+    "htmlTitle",  "htmlSnippet", "mime",    "fileFormat",  "pagemap",      "link" /* site */,
+    nullptr,      nullptr,       nullptr,   nullptr,       nullptr,        nullptr};
+
+// Partial response field mask for the projected columns, e.g. SELECT link -> items(link),queries(nextPage)
+static string BuildGoogleSearchFieldMask(const vector<column_t> &column_ids) {
+	vector<string> item_fields;
+	for (auto column_id : column_ids) {
+		if (column_id >= GOOGLE_SEARCH_COLUMN_COUNT || !GOOGLE_SEARCH_ITEM_FIELDS[column_id]) {
+			continue;
+		}
+		string field = GOOGLE_SEARCH_ITEM_FIELDS[column_id];
+		if (std::find(item_fields.begin(), item_fields.end(), field) == item_fields.end()) {
+			item_fields.push_back(field);
+		}
+	}
+	if (item_fields.empty()) {
+		// Still needed to count the results, e.g. for count(*)
+		item_fields.push_back("link");
+	}
+	return "items(" + StringUtil::Join(item_fields, ",") + "),queries(nextPage)";
+}
+
+static const vector<column_t> &AllGoogleSearchColumns() {
+	static const vector<column_t> column_ids = [] {
+		vector<column_t> ids;
+		for (column_t id = 0; id < GOOGLE_SEARCH_COLUMN_COUNT; id++) {
+			ids.push_back(id);
+		}
+		return ids;
+	}();
+	return column_ids;
+}
 
-	// Build query
+// Build the q parameter
+// or_sites: sites added as (site:a OR site:b) to the query, see SearchSitePlan
+static string BuildGoogleSearchQuery(const GoogleSearchBindData &bind_data, const vector<string> &or_sites) {
 	string full_query = bind_data.query;
 
 	// Prepend structured data filter (e.g., "more:pagemap:document-author:john")
@@ -163,19 +218,8 @@ static string BuildGoogleSearchUrl(const GoogleSearchBindData &bind_data, int st
 		full_query = bind_data.filters.structured_data + " " + full_query;
 	}
 
-	// Add site includes as OR clause (for LIMIT <= 100 with multiple sites)
-	if (use_or_sites && bind_data.site_includes.size() > 1) {
-		full_query += " (";
-		for (size_t i = 0; i < bind_data.site_includes.size(); i++) {
-			if (i > 0) {
-				full_query += " OR ";
-			}
-			full_query += "site:" + bind_data.site_includes[i];
-		}
-		full_query += ")";
-	} else if (use_or_sites && bind_data.site_includes.size() == 1) {
-		full_query += " site:" + bind_data.site_includes[0];
-	}
+	// Add site includes as OR clause
+	full_query += SearchSiteClause(or_sites);
 
 	// Add site excludes to query (-site:domain)
 	for (const auto &site : bind_data.site_excludes) {
@@ -186,22 +230,21 @@ static string BuildGoogleSearchUrl(const GoogleSearchBindData &bind_data, int st
 	if (!bind_data.term_query.empty()) {
 		full_query += " " + bind_data.term_query[0];
 	}
+	return full_query;
+}
 
-	url += "&q=" + UrlEncode(full_query);
-	url += "&num=10"; // Google max per page
-	url += "&start=" + std::to_string(start);
-
-	// Add site filter via siteSearch param (for LIMIT > 100, per-site queries)
-	if (!site_filter.empty()) {
-		url += "&siteSearch=" + UrlEncode(site_filter);
-		url += "&siteSearchFilter=i"; // i = include
-	}
+// Request parameters without the key and cx (see BuildSearchKeyUrl), q, siteSearch and start, which vary per
+// request, query and page. These are added by BuildGoogleSearchQueryUrl and BuildSearchPageUrl, so the filters are
+// only encoded once per scan.
+// fields: partial response field mask, see BuildGoogleSearchFieldMask
+static string BuildGoogleSearchParameters(const GoogleSearchBindData &bind_data, const string &fields) {
+	string url = "&num=10"; // Google max per page
 
 	// Add date restriction if set
 	if (bind_data.has_date_filter && bind_data.date_from.value != 0) {
 		string date_restrict = TimestampToDateRestrict(bind_data.date_from, bind_data.date_to);
 		if (!date_restrict.empty()) {
-			url += "&dateRestrict=" + UrlEncode(date_restrict);
+			AppendUrlParameter(url, "dateRestrict", date_restrict);
 		}
 	}
 
@@ -217,7 +260,7 @@ static string BuildGoogleSearchUrl(const GoogleSearchBindData &bind_data, int st
 		exact_terms += bind_data.pushed_exact_match;
 	}
 	if (!exact_terms.empty()) {
-		url += "&exactTerms=" + UrlEncode(exact_terms);
+		AppendUrlParameter(url, "exactTerms", exact_terms);
 	}
 
 	// Combine excludeTerms from named param and pushdown
@@ -229,7 +272,7 @@ static string BuildGoogleSearchUrl(const GoogleSearchBindData &bind_data, int st
 		exclude_terms += StringUtil::Join(bind_data.term_exclude, " ");
 	}
 	if (!exclude_terms.empty()) {
-		url += "&excludeTerms=" + UrlEncode(exclude_terms);
+		AppendUrlParameter(url, "excludeTerms", exclude_terms);
 	}
 
 	// Combine orTerms from named param and pushdown
@@ -241,98 +284,152 @@ static string BuildGoogleSearchUrl(const GoogleSearchBindData &bind_data, int st
 		or_terms += StringUtil::Join(bind_data.term_or, " ");
 	}
 	if (!or_terms.empty()) {
-		url += "&orTerms=" + UrlEncode(or_terms);
+		AppendUrlParameter(url, "orTerms", or_terms);
 	}
 	// File type: prefer pushed down value, then named param
 	if (!bind_data.pushed_file_type.empty()) {
-		url += "&fileType=" + UrlEncode(bind_data.pushed_file_type);
+		AppendUrlParameter(url, "fileType", bind_data.pushed_file_type);
 	} else if (!f.file_type.empty()) {
-		url += "&fileType=" + UrlEncode(f.file_type);
+		AppendUrlParameter(url, "fileType", f.file_type);
 	}
 	if (!f.gl.empty()) {
-		url += "&gl=" + UrlEncode(f.gl);
+		AppendUrlParameter(url, "gl", f.gl);
 	}
 	// Country restrict: prefer pushed down value, then named param
 	if (!bind_data.pushed_country.empty()) {
-		url += "&cr=" + UrlEncode(bind_data.pushed_country);
+		AppendUrlParameter(url, "cr", bind_data.pushed_country);
 	} else if (!f.cr.empty()) {
-		url += "&cr=" + UrlEncode(f.cr);
+		AppendUrlParameter(url, "cr", f.cr);
 	}
 	if (!f.hl.empty()) {
-		url += "&hl=" + UrlEncode(f.hl);
+		AppendUrlParameter(url, "hl", f.hl);
 	}
 	// Language restrict: prefer pushed down value, then named param
 	if (!bind_data.pushed_language.empty()) {
-		url += "&lr=" + UrlEncode(bind_data.pushed_language);
+		AppendUrlParameter(url, "lr", bind_data.pushed_language);
 	} else if (!f.language.empty()) {
-		url += "&lr=" + UrlEncode(f.language);
+		AppendUrlParameter(url, "lr", f.language);
 	}
 	if (!f.safe.empty()) {
-		url += "&safe=" + UrlEncode(f.safe);
+		AppendUrlParameter(url, "safe", f.safe);
 	}
 	if (!f.rights.empty()) {
-		url += "&rights=" + UrlEncode(f.rights);
+		AppendUrlParameter(url, "rights", f.rights);
 	}
 	if (!f.sort.empty()) {
-		url += "&sort=" + UrlEncode(f.sort);
+		AppendUrlParameter(url, "sort", f.sort);
 	}
 
 	// Request only needed fields for better performance
 	// See: https://developers.google.com/custom-search/v1/performance
-	url += "&fields=" + UrlEncode("items(title,link,snippet,displayLink,formattedUrl,htmlFormattedUrl,htmlTitle,"
-	                              "htmlSnippet,mime,fileFormat,pagemap),"
-	                              "queries(nextPage)");
+	AppendUrlParameter(url, "fields", fields);
 
 	return url;
 }
 
-// Parse JSON string helper
-static string GetJsonString(yyjson_val *obj, const char *key) {
-	yyjson_val *val = yyjson_obj_get(obj, key);
-	if (val && yyjson_is_str(val)) {
-		return yyjson_get_str(val);
+// Request parameters of one query, without the key and start parameters
+// or_sites: sites OR'd into the query
+// site_filter: single site for siteSearch param (a lone site in a multi-query plan)
+static string BuildGoogleSearchQueryUrl(const GoogleSearchBindData &bind_data, const string &parameters,
+                                        const vector<string> &or_sites = {}, const string &site_filter = "") {
+	string url = parameters;
+	AppendUrlParameter(url, "q", BuildGoogleSearchQuery(bind_data, or_sites));
+
+	// Add site filter via siteSearch param
+	if (!site_filter.empty()) {
+		AppendUrlParameter(url, "siteSearch", site_filter);
+		url += "&siteSearchFilter=i"; // i = include
 	}
-	return "";
+	return url;
 }
 
-// Parse a single API response and add results to state
-// Returns the next startIndex, or -1 if no more pages
-static int ParseGoogleSearchResponse(const string &response_body, GoogleSearchGlobalState &state,
-                                     const GoogleSearchBindData &bind_data) {
-	yyjson_doc *doc = yyjson_read(response_body.c_str(), response_body.size(), 0);
-	if (!doc) {
-		throw IOException("Failed to parse Google Search API response as JSON");
+// since_table := 'name': the links in the table's link column. The table is looked up through the caller's
+// catalog search path (so TEMP tables and the current schema work) and scanned in the caller's transaction, which
+// includes its uncommitted rows.
+static shared_ptr<const LinkHashSet> ReadSinceTableLinks(ClientContext &context, const string &table_name) {
+	auto name = QualifiedName::Parse(table_name);
+	optional_ptr<TableCatalogEntry> table;
+	try {
+		table = Catalog::GetEntry<TableCatalogEntry>(context, name.catalog, name.schema, name.name,
+		                                             OnEntryNotFound::RETURN_NULL);
+	} catch (CatalogException &ex) {
+		// e.g. a view
+		throw InvalidInputException("google_search: since_table '%s' must be a table with a link column: %s",
+		                            table_name, ex.what());
 	}
-
-	yyjson_val *root = yyjson_doc_get_root(doc);
-
-	// Check for API error
-	yyjson_val *error = yyjson_obj_get(root, "error");
-	if (error) {
-		yyjson_val *message = yyjson_obj_get(error, "message");
-		string err_msg = message && yyjson_is_str(message) ? yyjson_get_str(message) : "Unknown error";
-		yyjson_doc_free(doc);
-		throw InvalidInputException("Google Search API error: %s", err_msg);
+	if (!table || !table->ColumnExists("link") || table->GetColumn("link").Generated()) {
+		throw InvalidInputException("google_search: since_table '%s' must be a table with a link column", table_name);
+	}
+	if (!table->IsDuckTable()) {
+		throw InvalidInputException("google_search: since_table '%s' must be a DuckDB table", table_name);
+	}
+	auto &column = table->GetColumn("link");
+
+	auto &transaction = DuckTransaction::Get(context, table->ParentCatalog());
+	auto &storage = table->GetStorage();
+	TableScanState scan_state;
+	storage.InitializeScan(context, transaction, scan_state, {StorageIndex(column.StorageOid())});
+
+	auto links = make_shared_ptr<LinkHashSet>();
+	DataChunk chunk;
+	chunk.Initialize(context, {column.Type()});
+	Vector link_strings(LogicalType::VARCHAR);
+	while (true) {
+		chunk.Reset();
+		storage.Scan(transaction, chunk, scan_state);
+		if (chunk.size() == 0) {
+			break;
+		}
+		auto link_vector = &chunk.data[0];
+		if (column.Type().id() != LogicalTypeId::VARCHAR) {
+			VectorOperations::Cast(context, chunk.data[0], link_strings, chunk.size());
+			link_vector = &link_strings;
+		}
+		UnifiedVectorFormat format;
+		link_vector->ToUnifiedFormat(chunk.size(), format);
+		auto data = UnifiedVectorFormat::GetData<string_t>(format);
+		for (idx_t row = 0; row < chunk.size(); row++) {
+			auto idx = format.sel->get_index(row);
+			if (format.validity.RowIsValid(idx)) {
+				links->Insert(data[idx]);
+			}
+		}
 	}
+	return std::move(links);
+}
 
-	// Get items array
-	yyjson_val *items = yyjson_obj_get(root, "items");
-	if (!items || !yyjson_is_arr(items) || yyjson_arr_size(items) == 0) {
-		yyjson_doc_free(doc);
+// Parse a single API response and append up to max_results results
+// seen_links: if set, results with a link in the set are dropped (and don't count towards max_results)
+// known_links: if set, results with a link in the set are dropped, and a page of only known links is the last one
+// Returns the next startIndex, or -1 if no more pages
+static int ParseGoogleSearchResponse(const string &response_body, vector<GoogleSearchResult> &results,
+                                     idx_t max_results, LinkHashSet *seen_links = nullptr,
+                                     const LinkHashSet *known_links = nullptr) {
+	auto document = ReadSearchApiResponse(response_body);
+	yyjson_val *items = GetSearchApiItems(*document);
+	if (!items) {
 		return -1; // No results
 	}
 
 	// Process each item
 	size_t idx, max;
 	yyjson_val *item;
+	idx_t known_count = 0;
 	yyjson_arr_foreach(items, idx, max, item) {
-		if (state.results.size() >= bind_data.max_results) {
+		if (results.size() >= max_results) {
 			break;
 		}
 
 		GoogleSearchResult result;
-		result.title = GetJsonString(item, "title");
 		result.link = GetJsonString(item, "link");
+		if (known_links && known_links->Contains(result.link)) {
+			known_count++;
+			continue;
+		}
+		if (seen_links && !seen_links->Insert(result.link)) {
+			continue;
+		}
+		result.title = GetJsonString(item, "title");
 		result.snippet = GetJsonString(item, "snippet");
 		result.display_link = GetJsonString(item, "displayLink");
 		result.formatted_url = GetJsonString(item, "formattedUrl");
@@ -345,225 +442,163 @@ static int ParseGoogleSearchResponse(const string &response_body, GoogleSearchGl
 		// Extract site from link
 		result.site = ExtractDomain(result.link);
 
-		// Get pagemap as JSON string
+		// Kept as a node of the document, converted when written
 		yyjson_val *pagemap = yyjson_obj_get(item, "pagemap");
-		if (pagemap) {
-			char *pagemap_str = yyjson_val_write(pagemap, 0, nullptr);
-			if (pagemap_str) {
-				result.pagemap = pagemap_str;
-				free(pagemap_str);
-			}
+		if (pagemap && yyjson_is_obj(pagemap)) {
+			result.pagemap = pagemap;
 		}
 
-		state.results.push_back(result);
+		result.document = document;
+		document->result_count++;
+		results.push_back(std::move(result));
 	}
 
-	// Check for next page and extract startIndex
-	int next_start = -1;
-	yyjson_val *queries = yyjson_obj_get(root, "queries");
-	if (queries) {
-		yyjson_val *next_page = yyjson_obj_get(queries, "nextPage");
-		if (next_page && yyjson_is_arr(next_page) && yyjson_arr_size(next_page) > 0) {
-			yyjson_val *next_page_obj = yyjson_arr_get_first(next_page);
-			if (next_page_obj) {
-				yyjson_val *start_index = yyjson_obj_get(next_page_obj, "startIndex");
-				if (start_index && yyjson_is_int(start_index)) {
-					next_start = static_cast<int>(yyjson_get_int(start_index));
-				}
-			}
-		}
+	// Results are newest first (sort=date), so the pages after one with only known links hold known links too
+	if (known_links && max > 0 && known_count == max) {
+		return -1;
 	}
-
-	yyjson_doc_free(doc);
-	return next_start;
+	return GetSearchApiNextStart(*document);
 }
 
-// Fetch results from Google Search API
-static void FetchGoogleSearchResults(ClientContext &context, GoogleSearchGlobalState &state,
-                                     const GoogleSearchBindData &bind_data) {
-	RetryConfig retry_config;
-
-	// Decide mode based on LIMIT and number of sites
-	// - LIMIT <= 100: single query with (site:a OR site:b) syntax
-	// - LIMIT > 100 with multiple sites: separate queries per site (up to 100 each)
-	bool use_per_site_queries = bind_data.site_includes.size() > 1 && bind_data.max_results > 100;
-
-	if (use_per_site_queries) {
-		// Multi-site query mode: separate queries per site, round-robin
-		// Each site can return up to 100 results
-		state.site_states.resize(bind_data.site_includes.size());
-
-		while (state.results.size() < bind_data.max_results) {
-			// Count how many sites still have results
-			idx_t active_sites = 0;
-			for (const auto &ss : state.site_states) {
-				if (!ss.exhausted) {
-					active_sites++;
-				}
-			}
-			if (active_sites == 0) {
-				break; // All sites exhausted
-			}
-
-			// Find next non-exhausted site (round-robin)
-			idx_t attempts = 0;
-			while (state.site_states[state.current_site_idx].exhausted && attempts < bind_data.site_includes.size()) {
-				state.current_site_idx = (state.current_site_idx + 1) % bind_data.site_includes.size();
-				attempts++;
-			}
-
-			if (state.site_states[state.current_site_idx].exhausted) {
-				break; // All exhausted
-			}
-
-			auto &site_state = state.site_states[state.current_site_idx];
-			const string &site = bind_data.site_includes[state.current_site_idx];
-
-			// Per-site query: use siteSearch param, no OR syntax
-			string url = BuildGoogleSearchUrl(bind_data, site_state.next_start, site, false);
-			auto response = HttpClient::Fetch(context, url, retry_config);
-
-			if (!response.success) {
-				if (response.status_code == 429) {
-					// Rate limited - return partial results if we have any
-					if (!state.results.empty()) {
-						std::cerr << "Google Search API: Rate limit exceeded (429). Returning " << state.results.size()
-						          << " results." << std::endl;
-						return;
-					}
-					throw InvalidInputException(
-					    "Google Search API: Rate limit exceeded. Try again later or request higher quota.");
-				} else if (response.status_code == 401) {
-					throw InvalidInputException("Google Search API: Invalid API key");
-				} else if (response.status_code == 403) {
-					throw InvalidInputException("Google Search API: Access denied or quota exceeded");
-				} else if (response.status_code == 400) {
-					throw InvalidInputException("Google Search API: Invalid request - %s", response.error);
-				}
-				throw IOException("Google Search API error: %s (status %d)", response.error, response.status_code);
-			}
-
-			int next_start = ParseGoogleSearchResponse(response.body, state, bind_data);
-			if (next_start < 0 || site_state.next_start >= 100) {
-				site_state.exhausted = true; // Google max 100 per site
-			} else {
-				site_state.next_start = next_start;
-			}
-
-			// Move to next site for round-robin
-			state.current_site_idx = (state.current_site_idx + 1) % bind_data.site_includes.size();
-		}
-	} else {
-		// Single query mode: use (site:a OR site:b) syntax in query string
-		// This handles: no sites, single site, or multiple sites with LIMIT <= 100
-		bool has_sites = !bind_data.site_includes.empty();
-
-		while (state.results.size() < bind_data.max_results && !state.fetch_complete) {
-			// Single query with OR sites in query string
-			string url = BuildGoogleSearchUrl(bind_data, state.next_start, "", has_sites);
-			auto response = HttpClient::Fetch(context, url, retry_config);
-
-			if (!response.success) {
-				if (response.status_code == 429) {
-					// Rate limited - return partial results if we have any
-					if (!state.results.empty()) {
-						std::cerr << "Google Search API: Rate limit exceeded (429). Returning " << state.results.size()
-						          << " results." << std::endl;
-						state.fetch_complete = true;
-						return;
-					}
-					throw InvalidInputException(
-					    "Google Search API: Rate limit exceeded. Try again later or request higher quota.");
-				} else if (response.status_code == 401) {
-					throw InvalidInputException("Google Search API: Invalid API key");
-				} else if (response.status_code == 403) {
-					throw InvalidInputException("Google Search API: Access denied or quota exceeded");
-				} else if (response.status_code == 400) {
-					throw InvalidInputException("Google Search API: Invalid request - %s", response.error);
-				}
-				throw IOException("Google Search API error: %s (status %d)", response.error, response.status_code);
-			}
+// Split the site filter into queries for the (pushed down) LIMIT - see PlanSearchSites
+static SearchSitePlan PlanGoogleSearchSites(const GoogleSearchBindData &bind_data) {
+	auto base_query_length = BuildGoogleSearchQuery(bind_data, {}).size();
+	return PlanSearchSites(bind_data.site_includes, bind_data.max_results, base_query_length);
+}
 
-			int next_start = ParseGoogleSearchResponse(response.body, state, bind_data);
-			if (next_start < 0 || state.next_start >= 100) {
-				state.fetch_complete = true; // Google max 100 total
-			} else {
-				state.next_start = next_start;
-			}
+// Request parameters of each query of the site plan, by stream
+static vector<string> BuildGoogleSearchStreamUrls(const GoogleSearchBindData &bind_data, const SearchSitePlan &plan,
+                                                  const string &parameters) {
+	vector<string> urls;
+	if (plan.groups.empty()) {
+		urls.push_back(BuildGoogleSearchQueryUrl(bind_data, parameters));
+		return urls;
+	}
+	for (idx_t stream = 0; stream < plan.groups.size(); stream++) {
+		if (plan.UseSiteSearch(stream)) {
+			urls.push_back(BuildGoogleSearchQueryUrl(bind_data, parameters, {}, plan.groups[stream][0]));
+		} else {
+			urls.push_back(BuildGoogleSearchQueryUrl(bind_data, parameters, plan.groups[stream]));
 		}
 	}
+	return urls;
 }
 
-// Bind function
-static unique_ptr<FunctionData> GoogleSearchBind(ClientContext &context, TableFunctionBindInput &input,
-                                                 vector<LogicalType> &return_types, vector<string> &names) {
-	auto bind_data = make_uniq<GoogleSearchBindData>();
-
-	// First positional argument is the query
-	if (input.inputs.empty()) {
-		throw InvalidInputException("google_search() requires a search query");
-	}
-	bind_data->query = input.inputs[0].GetValue<string>();
-
-	// Get API credentials from secret
-	auto config = GetGoogleSearchConfigFromSecret(context);
-	bind_data->api_key = config.api_key;
-	bind_data->cx = config.cx;
-
-	// Parse named parameters (non-pushdown filters)
+// Named parameters shared by google_search() and google_search_each()
+static void BindGoogleSearchNamedParameters(TableFunctionBindInput &input, GoogleSearchBindData &bind_data) {
+	auto &filters = bind_data.filters;
 	for (auto &kv : input.named_parameters) {
 		auto key = StringUtil::Lower(kv.first);
 		string value = kv.second.GetValue<string>();
 
 		if (key == "exact_terms") {
-			bind_data->filters.exact_terms = value;
+			filters.exact_terms = value;
 		} else if (key == "exclude_terms") {
-			bind_data->filters.exclude_terms = value;
+			filters.exclude_terms = value;
 		} else if (key == "or_terms") {
-			bind_data->filters.or_terms = value;
+			filters.or_terms = value;
 		} else if (key == "file_type") {
-			bind_data->filters.file_type = value;
+			filters.file_type = value;
 		} else if (key == "country") {
-			bind_data->filters.gl = value;
+			filters.gl = value;
 		} else if (key == "cr") {
-			bind_data->filters.cr = value;
+			filters.cr = value;
 		} else if (key == "lr") {
-			bind_data->filters.language = value;
+			filters.language = value;
 		} else if (key == "language") {
-			bind_data->filters.language = value;
+			filters.language = value;
 		} else if (key == "interface_language") {
-			bind_data->filters.hl = value;
+			filters.hl = value;
 		} else if (key == "safe") {
-			bind_data->filters.safe = kv.second.GetValue<bool>() ? "active" : "off";
+			filters.safe = kv.second.GetValue<bool>() ? "active" : "off";
 		} else if (key == "rights") {
-			bind_data->filters.rights = value;
+			filters.rights = value;
 		} else if (key == "sort") {
-			bind_data->filters.sort = value;
+			filters.sort = value;
 		} else if (key == "structured_data") {
-			bind_data->filters.structured_data = value;
+			filters.structured_data = value;
+		} else if (key == "prefetch_pages") {
+			auto pages = kv.second.GetValue<int64_t>();
+			if (pages < 0) {
+				throw InvalidInputException("google_search: prefetch_pages must be >= 0 (0 = automatic)");
+			}
+			bind_data.prefetch_pages = static_cast<idx_t>(pages);
+		} else if (key == "max_results") {
+			auto max_results = kv.second.GetValue<int64_t>();
+			if (max_results < 1 || max_results > 100) {
+				throw InvalidInputException("google_search_each: max_results must be between 1 and 100");
+			}
+			bind_data.max_results = static_cast<idx_t>(max_results);
+		} else if (key == "dedupe") {
+			bind_data.dedupe = kv.second.GetValue<bool>();
+		} else if (key == "since_table") {
+			if (value.empty()) {
+				throw InvalidInputException("google_search: since_table must be a table name");
+			}
+			bind_data.since_table = value;
+		} else if (key == "pagemap_format") {
+			auto format = StringUtil::Lower(value);
+			if (format != "json" && format != "map") {
+				throw InvalidInputException("Unknown pagemap_format '%s'. Expected: json, map", value);
+			}
+			bind_data.pagemap_as_map = format == "map";
 		}
 	}
+	// Stopping at the first page of known links needs the newest results first
+	if (!bind_data.since_table.empty() && filters.sort.empty()) {
+		filters.sort = "date";
+	}
+}
 
+// pagemap_format := 'map': MAP(VARCHAR, MAP(VARCHAR, VARCHAR)[]), e.g. pagemap['metatags'][1]['og:image']
+static LogicalType GooglePagemapMapType() {
+	return LogicalType::MAP(LogicalType::VARCHAR,
+	                        LogicalType::LIST(LogicalType::MAP(LogicalType::VARCHAR, LogicalType::VARCHAR)));
+}
+
+// Result columns shared by google_search() and google_search_each()
+static void BindGoogleSearchColumns(GoogleSearchBindData &bind_data, vector<LogicalType> &return_types,
+                                    vector<string> &names) {
 	// Set output schema - includes site, date, language, country, file_type, term, exact_match for pushdown filtering
-	bind_data->column_names = {
+	bind_data.column_names = {
 	    "title",      "link",         "snippet", "display_link", "formatted_url", "html_formatted_url",
 	    "html_title", "html_snippet", "mime",    "file_format",  "pagemap",       "site",
 	    "date",       "language",     "country", "file_type",    "term",          "exact_match"};
 
-	for (const auto &name : bind_data->column_names) {
+	for (const auto &name : bind_data.column_names) {
 		names.emplace_back(name);
 	}
 
-	// Set column types - pagemap is JSON, rest are VARCHAR
-	for (size_t i = 0; i < bind_data->column_names.size(); i++) {
-		if (bind_data->column_names[i] == "pagemap") {
-			return_types.emplace_back(LogicalType::JSON());
-			bind_data->column_types.emplace_back(LogicalType::JSON());
+	// Set column types - pagemap is JSON (or MAP with pagemap_format := 'map'), rest are VARCHAR
+	for (size_t i = 0; i < bind_data.column_names.size(); i++) {
+		if (bind_data.column_names[i] == "pagemap") {
+			auto type = bind_data.pagemap_as_map ? GooglePagemapMapType() : LogicalType::JSON();
+			return_types.emplace_back(type);
+			bind_data.column_types.emplace_back(type);
 		} else {
 			return_types.emplace_back(LogicalType::VARCHAR);
-			bind_data->column_types.emplace_back(LogicalType::VARCHAR);
+			bind_data.column_types.emplace_back(LogicalType::VARCHAR);
 		}
 	}
+}
+
+// Bind function
+static unique_ptr<FunctionData> GoogleSearchBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	auto bind_data = make_uniq<GoogleSearchBindData>();
+
+	// First positional argument is the query
+	if (input.inputs.empty()) {
+		throw InvalidInputException("google_search() requires a search query");
+	}
+	bind_data->query = input.inputs[0].GetValue<string>();
+
+	// Get API credentials from secret
+	bind_data->keys = GetGoogleSearchConfigsFromSecrets(context, input.named_parameters);
+
+	// Parse named parameters (non-pushdown filters)
+	BindGoogleSearchNamedParameters(input, *bind_data);
+	BindGoogleSearchColumns(*bind_data, return_types, names);
 
 	return std::move(bind_data);
 }
@@ -881,52 +916,453 @@ static void GoogleSearchPushdownComplexFilter(ClientContext &context, LogicalGet
 // Global init function
 static unique_ptr<GlobalTableFunctionState> GoogleSearchInitGlobal(ClientContext &context,
                                                                    TableFunctionInitInput &input) {
-	auto state = make_uniq<GoogleSearchGlobalState>();
 	auto &bind_data = input.bind_data->Cast<GoogleSearchBindData>();
+	auto plan = PlanGoogleSearchSites(bind_data);
 
-	// Fetch all results up front
-	FetchGoogleSearchResults(context, *state, bind_data);
-
+	// Only request the fields of the projected columns (and the link to deduplicate on)
+	auto mask_columns = input.column_ids;
+	if (bind_data.dedupe || !bind_data.since_table.empty()) {
+		mask_columns.push_back(LINK_COLUMN);
+	}
+	auto fields = BuildGoogleSearchFieldMask(mask_columns);
+
+	// The filters are final once the pushdowns ran, so the URLs are built once here
+	auto parameters = BuildGoogleSearchParameters(bind_data, fields);
+	auto key_urls = BuildSearchKeyUrls(context, bind_data.keys);
+	auto cache_mode = plan.ToString() + (bind_data.dedupe ? "#dedupe" : "");
+	shared_ptr<const LinkHashSet> known_links;
+	if (!bind_data.since_table.empty()) {
+		// Cached results are only valid for the same known links
+		known_links = ReadSinceTableLinks(context, bind_data.since_table);
+		cache_mode += "#since=" + std::to_string(known_links->Count()) + ":" + std::to_string(known_links->Checksum());
+	}
+	auto cache_key =
+	    ResultCacheKey(key_urls[0] + BuildGoogleSearchQueryUrl(bind_data, parameters, bind_data.site_includes),
+	                   bind_data.max_results, cache_mode);
+	// since_table: one page at a time per query, so none is requested past the first page of known links
+	idx_t window =
+	    GetSearchPageWindow(bind_data.prefetch_pages, bind_data.limit_pushed && bind_data.since_table.empty());
+	auto state = InitSearchScanState<GoogleSearchGlobalState, GoogleSearchResult>(
+	    context, input.column_ids, std::move(fields), std::move(cache_key), plan.QueryCount(), bind_data.max_results,
+	    window);
+	state->known_links = std::move(known_links);
+	if (bind_data.dedupe) {
+		// Which copy of a link is kept must not depend on which request finished first: one thread emits the pages
+		// in page order and drops the duplicates as it goes (its claimed pages are still fetched concurrently)
+		state->max_threads = 1;
+		state->complete_on_emit = true;
+	}
+	state->key_urls = std::move(key_urls);
+	state->stream_urls = BuildGoogleSearchStreamUrls(bind_data, plan, parameters);
+	state->plan = std::move(plan);
 	return std::move(state);
 }
 
+// Result fields in output column order (title .. site), pagemap is written separately
+static string_t GoogleSearchResult::*const RESULT_STRING_COLUMNS[] = {
+    &GoogleSearchResult::title,        &GoogleSearchResult::link,          &GoogleSearchResult::snippet,
+    &GoogleSearchResult::display_link, &GoogleSearchResult::formatted_url, &GoogleSearchResult::html_formatted_url,
+    &GoogleSearchResult::html_title,   &GoogleSearchResult::html_snippet,  &GoogleSearchResult::mime,
+    &GoogleSearchResult::file_format,  nullptr,                            &GoogleSearchResult::site};
+
+// A JSON value as VARCHAR: strings as they are, anything else as JSON text
+static string_t GooglePagemapString(Vector &target, yyjson_val *val) {
+	if (yyjson_is_str(val)) {
+		return StringVector::AddString(target, yyjson_get_str(val), yyjson_get_len(val));
+	}
+	size_t len = 0;
+	char *text = yyjson_val_write(val, 0, &len);
+	if (!text) {
+		return string_t("", 0);
+	}
+	auto result = StringVector::AddString(target, text, len);
+	free(text);
+	return result;
+}
+
+static void WriteGooglePagemapJson(Vector &column, const vector<GoogleSearchResult> &results, idx_t start,
+                                   idx_t count) {
+	auto data = FlatVector::GetData<string_t>(column);
+	for (idx_t row = 0; row < count; row++) {
+		auto pagemap = results[start + row].pagemap;
+		data[row] = pagemap ? GooglePagemapString(column, pagemap) : string_t("", 0);
+	}
+}
+
+// Append the members of a JSON object as one MAP(VARCHAR, VARCHAR) row
+static void AppendPagemapObject(Vector &map, idx_t row, yyjson_val *obj) {
+	auto list_data = FlatVector::GetData<list_entry_t>(map);
+	auto offset = ListVector::GetListSize(map);
+	if (!yyjson_is_obj(obj)) {
+		FlatVector::SetNull(map, row, true);
+		list_data[row] = list_entry_t(offset, 0);
+		return;
+	}
+	auto size = yyjson_obj_size(obj);
+	ListVector::Reserve(map, offset + size);
+	auto &keys = MapVector::GetKeys(map);
+	auto &values = MapVector::GetValues(map);
+	auto key_data = FlatVector::GetData<string_t>(keys);
+	auto value_data = FlatVector::GetData<string_t>(values);
+
+	size_t idx, max;
+	yyjson_val *key, *val;
+	yyjson_obj_foreach(obj, idx, max, key, val) {
+		key_data[offset + idx] = StringVector::AddString(keys, yyjson_get_str(key), yyjson_get_len(key));
+		value_data[offset + idx] = GooglePagemapString(values, val);
+	}
+	list_data[row] = list_entry_t(offset, size);
+	ListVector::SetListSize(map, offset + size);
+}
+
+// Append a JSON array of objects as one MAP(VARCHAR, VARCHAR)[] row
+static void AppendPagemapObjectList(Vector &list, idx_t row, yyjson_val *arr) {
+	auto list_data = FlatVector::GetData<list_entry_t>(list);
+	auto offset = ListVector::GetListSize(list);
+	if (!yyjson_is_arr(arr)) {
+		FlatVector::SetNull(list, row, true);
+		list_data[row] = list_entry_t(offset, 0);
+		return;
+	}
+	auto size = yyjson_arr_size(arr);
+	ListVector::Reserve(list, offset + size);
+	// Set the size first - appending to the child map grows its own child lists
+	ListVector::SetListSize(list, offset + size);
+	auto &maps = ListVector::GetEntry(list);
+
+	size_t idx, max;
+	yyjson_val *obj;
+	yyjson_arr_foreach(arr, idx, max, obj) {
+		AppendPagemapObject(maps, offset + idx, obj);
+	}
+	list_data[row] = list_entry_t(offset, size);
+}
+
+// Build the MAP column straight from the document, without a JSON round trip
+static void WriteGooglePagemapMap(Vector &column, const vector<GoogleSearchResult> &results, idx_t start,
+                                  idx_t count) {
+	auto list_data = FlatVector::GetData<list_entry_t>(column);
+	for (idx_t row = 0; row < count; row++) {
+		auto pagemap = results[start + row].pagemap;
+		auto offset = ListVector::GetListSize(column);
+		if (!pagemap) {
+			FlatVector::SetNull(column, row, true);
+			list_data[row] = list_entry_t(offset, 0);
+			continue;
+		}
+		auto size = yyjson_obj_size(pagemap);
+		ListVector::Reserve(column, offset + size);
+		ListVector::SetListSize(column, offset + size);
+		auto &keys = MapVector::GetKeys(column);
+		auto &values = MapVector::GetValues(column);
+
+		size_t idx, max;
+		yyjson_val *key, *val;
+		yyjson_obj_foreach(pagemap, idx, max, key, val) {
+			FlatVector::GetData<string_t>(keys)[offset + idx] =
+			    StringVector::AddString(keys, yyjson_get_str(key), yyjson_get_len(key));
+			AppendPagemapObjectList(values, offset + idx, val);
+		}
+		list_data[row] = list_entry_t(offset, size);
+	}
+}
+
+// Write results[start, start + count) of one column straight into its output vector
+static void WriteGoogleSearchColumn(Vector &column, column_t column_id, const vector<GoogleSearchResult> &results,
+                                    idx_t start, idx_t count, const GoogleSearchBindData &bind_data) {
+	if (column_id <= SITE_COLUMN && column_id != PAGEMAP_COLUMN) {
+		// No copy: the strings stay in the response documents
+		auto data = FlatVector::GetData<string_t>(column);
+		auto field = RESULT_STRING_COLUMNS[column_id];
+		for (idx_t row = 0; row < count; row++) {
+			data[row] = results[start + row].*field;
+		}
+		AttachSearchApiDocuments(column, results, start, count);
+		return;
+	}
+
+	switch (column_id) {
+	case PAGEMAP_COLUMN:
+		if (bind_data.pagemap_as_map) {
+			WriteGooglePagemapMap(column, results, start, count);
+		} else {
+			WriteGooglePagemapJson(column, results, start, count);
+		}
+		break;
+	case DATE_COLUMN: {
+		auto data = FlatVector::GetData<string_t>(column);
+		for (idx_t row = 0; row < count; row++) {
+			auto &date = results[start + row].date;
+			if (date.GetSize() == 0) {
+				FlatVector::SetNull(column, row, true);
+			} else {
+				data[row] = date;
+			}
+		}
+		AttachSearchApiDocuments(column, results, start, count);
+		break;
+	}
+	// Language, country, file_type, term, exact_match columns return the pushed down filter value or NULL
+	case LANGUAGE_COLUMN:
+		SetSearchFilterColumn(column, bind_data.pushed_language);
+		break;
+	case COUNTRY_COLUMN:
+		SetSearchFilterColumn(column, bind_data.pushed_country);
+		break;
+	case FILE_TYPE_COLUMN:
+		SetSearchFilterColumn(column, bind_data.pushed_file_type);
+		break;
+	case EXACT_MATCH_COLUMN:
+		SetSearchFilterColumn(column, bind_data.pushed_exact_match);
+		break;
+	case TERM_COLUMN: // term column is virtual for pushdown only
+	default:
+		SetSearchFilterColumn(column, string());
+		break;
+	}
+}
+
+// Write results[start, start + count) of the projected columns, starting at output column col_offset
+static void WriteGoogleSearchRows(DataChunk &output, idx_t col_offset, const vector<column_t> &column_ids,
+                                  const vector<GoogleSearchResult> &results, idx_t start, idx_t count,
+                                  const GoogleSearchBindData &bind_data) {
+	for (idx_t col = 0; col < column_ids.size(); col++) {
+		WriteGoogleSearchColumn(output.data[col_offset + col], column_ids[col], results, start, count, bind_data);
+	}
+}
+
+// dedupe := true: drop the results of a page whose link was returned before, as the page is emitted in page order.
+// Deduplicated pages count fewer results, so the scheduler claims further pages to fill the LIMIT.
+static void DedupeGoogleSearchPage(GoogleSearchGlobalState &state, vector<GoogleSearchResult> &results) {
+	idx_t kept = 0;
+	for (idx_t i = 0; i < results.size(); i++) {
+		if (!state.seen_links.Insert(results[i].link)) {
+			continue;
+		}
+		if (kept != i) {
+			results[kept] = std::move(results[i]);
+		}
+		kept++;
+	}
+	results.resize(kept);
+}
+
 // Scan function
 static void GoogleSearchScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
 	auto &state = data.global_state->Cast<GoogleSearchGlobalState>();
+	auto &local = data.local_state->Cast<SearchScanLocalState<GoogleSearchResult>>();
+	auto &bind_data = data.bind_data->Cast<GoogleSearchBindData>();
+
+	auto build_url = [&](const SearchPageUnit &unit) { return BuildSearchPageUrl(context, state, unit); };
+	// Drops the known links of since_table; dedupe := true is applied on emit
+	auto parse = [&](const string &body, vector<GoogleSearchResult> &results) {
+		return ParseGoogleSearchResponse(body, results, SEARCH_RESULTS_PER_PAGE, nullptr, state.known_links.get());
+	};
+	auto dedupe = [&](vector<GoogleSearchResult> &results) { DedupeGoogleSearchPage(state, results); };
+	if (!SearchScanNextRows(context, state, local, build_url, parse, dedupe)) {
+		output.SetCardinality(0);
+		return;
+	}
+
+	auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, local.results.size() - local.current_idx);
+	WriteGoogleSearchRows(output, 0, state.column_ids, local.results, local.current_idx, count, bind_data);
+	local.current_idx += count;
+	output.SetCardinality(count);
+}
+
+// Results of the planned queries, up to the pushed down LIMIT
+static unique_ptr<NodeStatistics> GoogleSearchCardinality(ClientContext &context, const FunctionData *bind_data_p) {
+	auto &bind_data = bind_data_p->Cast<GoogleSearchBindData>();
+	auto results = PlanGoogleSearchSites(bind_data).estimated_results;
+	return make_uniq<NodeStatistics>(results, results);
+}
+
+// google_search_each(): one search per input row, all requests of an input chunk are sent concurrently
+struct GoogleSearchEachLocalState : public LocalTableFunctionState {
+	// Results of the current input chunk in input order, with the input row each one belongs to
+	vector<GoogleSearchResult> results;
+	vector<idx_t> result_rows;
+	idx_t current_idx = 0;
+	bool input_fetched = false;
+
+	// Request URL prefix of each secret, and the parameters without the query and start (the same for every row)
+	vector<string> key_urls;
+	string parameters;
+	shared_ptr<const LinkHashSet> known_links; // since_table := '...'
+
+	idx_t total_results = 0; // Across all input chunks
+	bool rate_limited = false;
+};
+
+// since_table := '...': the known links, read once for all threads
+struct GoogleSearchEachGlobalState : public GlobalTableFunctionState {
+	shared_ptr<const LinkHashSet> known_links;
+};
+
+// Bind function - the input is a single VARCHAR column of queries (a subquery, or the lateral column)
+static unique_ptr<FunctionData> GoogleSearchEachBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	if (input.input_table_types.size() != 1 || input.input_table_types[0].id() != LogicalTypeId::VARCHAR) {
+		throw InvalidInputException("google_search_each() expects a single VARCHAR column of search queries");
+	}
+
+	auto bind_data = make_uniq<GoogleSearchBindData>();
+	bind_data->max_results = SEARCH_RESULTS_PER_PAGE; // One page per query unless max_results is given
+
+	bind_data->keys = GetGoogleSearchConfigsFromSecrets(context, input.named_parameters);
+
+	BindGoogleSearchNamedParameters(input, *bind_data);
+
+	names.emplace_back("query");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	BindGoogleSearchColumns(*bind_data, return_types, names);
+
+	return std::move(bind_data);
+}
+
+static unique_ptr<GlobalTableFunctionState> GoogleSearchEachInitGlobal(ClientContext &context,
+                                                                       TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<GoogleSearchBindData>();
+	auto result = make_uniq<GoogleSearchEachGlobalState>();
+	if (!bind_data.since_table.empty()) {
+		result->known_links = ReadSinceTableLinks(context, bind_data.since_table);
+	}
+	return std::move(result);
+}
+
+static unique_ptr<LocalTableFunctionState> GoogleSearchEachInitLocal(ExecutionContext &context,
+                                                                     TableFunctionInitInput &input,
+                                                                     GlobalTableFunctionState *global_state) {
+	auto &bind_data = input.bind_data->Cast<GoogleSearchBindData>();
+	auto result = make_uniq<GoogleSearchEachLocalState>();
+	result->key_urls = BuildSearchKeyUrls(context.client, bind_data.keys);
+	result->parameters = BuildGoogleSearchParameters(bind_data, BuildGoogleSearchFieldMask(AllGoogleSearchColumns()));
+	result->known_links = global_state->Cast<GoogleSearchEachGlobalState>().known_links;
+	return std::move(result);
+}
+
+// A query of an input chunk of google_search_each()
+struct GoogleSearchEachQuery {
+	idx_t row;
+	string query_url;
+	vector<GoogleSearchResult> results;
+	LinkHashSet seen_links; // dedupe := true
+	bool done = false;      // Past its last page
+};
+
+// Fetch the results of every query in the input chunk
+static void FetchGoogleSearchEachChunk(ClientContext &context, GoogleSearchEachLocalState &state,
+                                       const GoogleSearchBindData &bind_data, DataChunk &input) {
+	auto retry_config = RetryConfig::FromContext(context);
+	idx_t page_count = (bind_data.max_results + SEARCH_RESULTS_PER_PAGE - 1) / SEARCH_RESULTS_PER_PAGE;
+
+	auto row_bind_data = bind_data;
+	vector<GoogleSearchEachQuery> queries;
+	for (idx_t row = 0; row < input.size(); row++) {
+		auto query = input.GetValue(0, row);
+		if (query.IsNull()) {
+			continue;
+		}
+		row_bind_data.query = query.GetValue<string>();
+		if (row_bind_data.query.empty()) {
+			continue;
+		}
+		queries.emplace_back();
+		queries.back().row = row;
+		queries.back().query_url = BuildGoogleSearchQueryUrl(row_bind_data, state.parameters);
+	}
+
+	// Start offsets are predictable, so every page of every query is requested at once. With since_table, a page at a
+	// time per query instead, so no query is paged past its first page of only known links.
+	idx_t pages_per_round = state.known_links ? 1 : page_count;
+	idx_t result_count = 0;
+	for (idx_t first_page = 0; first_page < page_count && !state.rate_limited; first_page += pages_per_round) {
+		auto end_page = MinValue<idx_t>(first_page + pages_per_round, page_count);
+		vector<string> url_suffixes;
+		vector<idx_t> url_queries;
+		for (idx_t query_idx = 0; query_idx < queries.size(); query_idx++) {
+			if (queries[query_idx].done) {
+				continue;
+			}
+			for (idx_t page = first_page; page < end_page; page++) {
+				url_suffixes.push_back(queries[query_idx].query_url + "&start=" +
+				                       std::to_string(1 + page * SEARCH_RESULTS_PER_PAGE));
+				url_queries.push_back(query_idx);
+			}
+		}
+		if (url_suffixes.empty()) {
+			break;
+		}
+
+		auto responses = FetchAllAcrossKeys(context, state.key_urls, url_suffixes, retry_config);
+
+		// Merge each query's pages in order, dropping everything after its last page
+		for (idx_t url_idx = 0; url_idx < responses.size(); url_idx++) {
+			auto &query = queries[url_queries[url_idx]];
+			if (query.done) {
+				continue;
+			}
+			if (!CheckSearchApiResponse(responses[url_idx], state.total_results + result_count)) {
+				state.rate_limited = true;
+				break;
+			}
+			auto before = query.results.size();
+			if (ParseGoogleSearchResponse(responses[url_idx].body, query.results, bind_data.max_results,
+			                              bind_data.dedupe ? &query.seen_links : nullptr,
+			                              state.known_links.get()) < 0 ||
+			    query.results.size() >= bind_data.max_results) {
+				query.done = true;
+			}
+			result_count += query.results.size() - before;
+		}
+	}
+
+	for (auto &query : queries) {
+		for (auto &result : query.results) {
+			state.results.push_back(std::move(result));
+			state.result_rows.push_back(query.row);
+		}
+	}
+	state.total_results += result_count;
+}
+
+static OperatorResultType GoogleSearchEachFunction(ExecutionContext &context, TableFunctionInput &data,
+                                                   DataChunk &input, DataChunk &output) {
+	auto &state = data.local_state->Cast<GoogleSearchEachLocalState>();
 	auto &bind_data = data.bind_data->Cast<GoogleSearchBindData>();
 
-	idx_t count = 0;
-	idx_t max_count = STANDARD_VECTOR_SIZE;
-
-	while (count < max_count && state.current_idx < state.results.size()) {
-		auto &result = state.results[state.current_idx];
-
-		output.SetValue(0, count, Value(result.title));
-		output.SetValue(1, count, Value(result.link));
-		output.SetValue(2, count, Value(result.snippet));
-		output.SetValue(3, count, Value(result.display_link));
-		output.SetValue(4, count, Value(result.formatted_url));
-		output.SetValue(5, count, Value(result.html_formatted_url));
-		output.SetValue(6, count, Value(result.html_title));
-		output.SetValue(7, count, Value(result.html_snippet));
-		output.SetValue(8, count, Value(result.mime));
-		output.SetValue(9, count, Value(result.file_format));
-		output.SetValue(10, count, Value(result.pagemap));
-		output.SetValue(11, count, Value(result.site));
-		output.SetValue(12, count, result.date.empty() ? Value() : Value(result.date));
-		// Language, country, file_type, term, exact_match columns return the pushed down filter value or NULL
-		output.SetValue(13, count, bind_data.pushed_language.empty() ? Value() : Value(bind_data.pushed_language));
-		output.SetValue(14, count, bind_data.pushed_country.empty() ? Value() : Value(bind_data.pushed_country));
-		output.SetValue(15, count, bind_data.pushed_file_type.empty() ? Value() : Value(bind_data.pushed_file_type));
-		output.SetValue(16, count, Value()); // term column is virtual for pushdown only
-		output.SetValue(17, count,
-		                bind_data.pushed_exact_match.empty() ? Value() : Value(bind_data.pushed_exact_match));
-
-		state.current_idx++;
-		count++;
+	if (!state.input_fetched) {
+		if (state.rate_limited) {
+			return OperatorResultType::FINISHED;
+		}
+		FetchGoogleSearchEachChunk(context.client, state, bind_data, input);
+		state.input_fetched = true;
 	}
 
+	auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, state.results.size() - state.current_idx);
+	UnifiedVectorFormat queries;
+	input.data[0].ToUnifiedFormat(input.size(), queries);
+	auto query_data = UnifiedVectorFormat::GetData<string_t>(queries);
+	auto &query_vector = output.data[0];
+	auto query_output = FlatVector::GetData<string_t>(query_vector);
+	for (idx_t row = 0; row < count; row++) {
+		// Rows without a query have no results, so every input row here is valid
+		auto input_idx = queries.sel->get_index(state.result_rows[state.current_idx + row]);
+		query_output[row] = StringVector::AddString(query_vector, query_data[input_idx]);
+	}
+	WriteGoogleSearchRows(output, 1, AllGoogleSearchColumns(), state.results, state.current_idx, count, bind_data);
+	state.current_idx += count;
 	output.SetCardinality(count);
+
+	if (state.current_idx < state.results.size()) {
+		return OperatorResultType::HAVE_MORE_OUTPUT;
+	}
+	// Input chunk done
+	state.results.clear();
+	state.result_rows.clear();
+	state.current_idx = 0;
+	state.input_fetched = false;
+	return OperatorResultType::NEED_MORE_INPUT;
 }
 
 // LIMIT pushdown optimizer
@@ -963,8 +1399,10 @@ void OptimizeGoogleSearchLimitPushdown(unique_ptr<LogicalOperator> &op) {
 		auto &bind_data = get.bind_data->Cast<GoogleSearchBindData>();
 		if (limit.limit_val.Type() == LimitNodeType::CONSTANT_VALUE) {
 			auto limit_value = limit.limit_val.GetConstantValue();
-			// Cap at 100 (Google API max)
-			bind_data.max_results = std::min(limit_value, (idx_t)100);
+			// Cap at 100 per query (Google API max); per-site mode runs one query per site
+			idx_t query_count = MaxValue<idx_t>(bind_data.site_includes.size(), 1);
+			bind_data.max_results = std::min(limit_value, (idx_t)100 * query_count);
+			bind_data.limit_pushed = true;
 		}
 		return;
 	}
@@ -977,75 +1415,14 @@ void OptimizeGoogleSearchLimitPushdown(unique_ptr<LogicalOperator> &op) {
 
 // ORDER BY pushdown optimizer - converts ORDER BY date to API sort parameter
 void OptimizeGoogleSearchOrderByPushdown(unique_ptr<LogicalOperator> &op) {
-	if (op->type == LogicalOperatorType::LOGICAL_ORDER_BY) {
-		auto &order = op->Cast<LogicalOrder>();
-		reference<LogicalOperator> child = *op->children[0];
-
-		// Skip projection operators to find the GET
-		while (child.get().type == LogicalOperatorType::LOGICAL_PROJECTION) {
-			child = *child.get().children[0];
-		}
-
-		if (child.get().type != LogicalOperatorType::LOGICAL_GET) {
-			OptimizeGoogleSearchOrderByPushdown(op->children[0]);
-			return;
-		}
-
-		auto &get = child.get().Cast<LogicalGet>();
-		if (get.function.name != "google_search") {
-			OptimizeGoogleSearchOrderByPushdown(op->children[0]);
-			return;
-		}
-
-		// Check if ordering by a single column
-		if (order.orders.size() != 1) {
-			OptimizeGoogleSearchOrderByPushdown(op->children[0]);
-			return;
-		}
-
-		auto &order_node = order.orders[0];
-		auto &expr = order_node.expression;
-
-		// Check if it's a column reference
-		if (expr->type != ExpressionType::BOUND_COLUMN_REF) {
-			OptimizeGoogleSearchOrderByPushdown(op->children[0]);
-			return;
-		}
-
-		auto &col_ref = expr->Cast<BoundColumnRefExpression>();
-
-		// Get column name from bind data
-		auto &bind_data = get.bind_data->Cast<GoogleSearchBindData>();
-		idx_t col_idx = col_ref.binding.column_index;
-
-		if (col_idx >= bind_data.column_names.size()) {
-			OptimizeGoogleSearchOrderByPushdown(op->children[0]);
-			return;
-		}
-
-		string col_name = bind_data.column_names[col_idx];
-
-		// Map column name to Google sort parameter
-		string sort_param;
-		if (col_name == "date") {
-			// Map to Google's date sort (estimated page date)
-			// See: https://developers.google.com/custom-search/docs/structured_search
-			if (order_node.type == OrderType::DESCENDING) {
-				sort_param = "date:d";
-			} else {
-				sort_param = "date:a";
-			}
-		} else {
-			// Column not supported for ORDER BY pushdown
-			OptimizeGoogleSearchOrderByPushdown(op->children[0]);
-			return;
-		}
-
+	string sort_param;
+	auto get = MatchSearchOrderByDate(*op, "google_search", sort_param);
+	if (get) {
 		// Set the sort parameter (only if not already set via named param)
+		auto &bind_data = get->bind_data->Cast<GoogleSearchBindData>();
 		if (bind_data.filters.sort.empty()) {
 			bind_data.filters.sort = sort_param;
 		}
-
 		return;
 	}
 
@@ -1055,30 +1432,69 @@ void OptimizeGoogleSearchOrderByPushdown(unique_ptr<LogicalOperator> &op) {
 	}
 }
 
-// Register the table function
+// EXPLAIN: the site plan chosen for the pushed down filters and LIMIT
+static InsertionOrderPreservingMap<string> GoogleSearchToString(TableFunctionToStringInput &input) {
+	InsertionOrderPreservingMap<string> result;
+	auto &bind_data = input.bind_data->Cast<GoogleSearchBindData>();
+	auto plan = PlanGoogleSearchSites(bind_data);
+	result["Query"] = bind_data.query;
+	result["Site Plan"] = plan.ToString();
+	result["Estimated Requests"] = std::to_string(plan.estimated_requests);
+	if (!bind_data.since_table.empty()) {
+		result["Since Table"] = bind_data.since_table;
+	}
+	return result;
+}
+
+static void AddGoogleSearchNamedParameters(TableFunction &function) {
+	function.named_parameters["exact_terms"] = LogicalType::VARCHAR;
+	function.named_parameters["exclude_terms"] = LogicalType::VARCHAR;
+	function.named_parameters["or_terms"] = LogicalType::VARCHAR;
+	function.named_parameters["file_type"] = LogicalType::VARCHAR;
+	function.named_parameters["country"] = LogicalType::VARCHAR;
+	function.named_parameters["cr"] = LogicalType::VARCHAR;
+	function.named_parameters["lr"] = LogicalType::VARCHAR;
+	function.named_parameters["language"] = LogicalType::VARCHAR;
+	function.named_parameters["interface_language"] = LogicalType::VARCHAR;
+	function.named_parameters["safe"] = LogicalType::BOOLEAN;
+	function.named_parameters["rights"] = LogicalType::VARCHAR;
+	function.named_parameters["sort"] = LogicalType::VARCHAR;
+	function.named_parameters["structured_data"] = LogicalType::VARCHAR;
+	function.named_parameters["pagemap_format"] = LogicalType::VARCHAR;
+	function.named_parameters["dedupe"] = LogicalType::BOOLEAN;
+	function.named_parameters["since_table"] = LogicalType::VARCHAR;
+	function.named_parameters["secret"] = LogicalType::VARCHAR;
+	function.named_parameters["secrets"] = LogicalType::LIST(LogicalType::VARCHAR);
+}
+
+// Register the table functions
 void RegisterGoogleSearchFunction(ExtensionLoader &loader) {
 	TableFunction google_search_func("google_search", {LogicalType::VARCHAR}, GoogleSearchScan, GoogleSearchBind,
-	                                 GoogleSearchInitGlobal);
+	                                 GoogleSearchInitGlobal, SearchScanInitLocal<GoogleSearchResult>);
+	google_search_func.get_partition_data = SearchScanGetPartitionData<GoogleSearchResult>;
 
-	// Enable filter pushdown
+	// Enable filter and projection pushdown
 	google_search_func.pushdown_complex_filter = GoogleSearchPushdownComplexFilter;
+	google_search_func.projection_pushdown = true;
+	google_search_func.to_string = GoogleSearchToString;
+	google_search_func.dynamic_to_string = SearchScanDynamicToString<GoogleSearchResult>;
+	google_search_func.cardinality = GoogleSearchCardinality;
+	google_search_func.table_scan_progress = SearchScanProgress<GoogleSearchResult>;
 
 	// Named parameters for non-pushdown filters
-	google_search_func.named_parameters["exact_terms"] = LogicalType::VARCHAR;
-	google_search_func.named_parameters["exclude_terms"] = LogicalType::VARCHAR;
-	google_search_func.named_parameters["or_terms"] = LogicalType::VARCHAR;
-	google_search_func.named_parameters["file_type"] = LogicalType::VARCHAR;
-	google_search_func.named_parameters["country"] = LogicalType::VARCHAR;
-	google_search_func.named_parameters["cr"] = LogicalType::VARCHAR;
-	google_search_func.named_parameters["lr"] = LogicalType::VARCHAR;
-	google_search_func.named_parameters["language"] = LogicalType::VARCHAR;
-	google_search_func.named_parameters["interface_language"] = LogicalType::VARCHAR;
-	google_search_func.named_parameters["safe"] = LogicalType::BOOLEAN;
-	google_search_func.named_parameters["rights"] = LogicalType::VARCHAR;
-	google_search_func.named_parameters["sort"] = LogicalType::VARCHAR;
-	google_search_func.named_parameters["structured_data"] = LogicalType::VARCHAR;
+	AddGoogleSearchNamedParameters(google_search_func);
+	google_search_func.named_parameters["prefetch_pages"] = LogicalType::INTEGER;
 
 	loader.RegisterFunction(google_search_func);
+
+	// google_search_each((SELECT q FROM queries)) or FROM queries, google_search_each(q)
+	TableFunction google_search_each_func("google_search_each", {LogicalType::TABLE}, nullptr, GoogleSearchEachBind,
+	                                      GoogleSearchEachInitGlobal, GoogleSearchEachInitLocal);
+	google_search_each_func.in_out_function = GoogleSearchEachFunction;
+	AddGoogleSearchNamedParameters(google_search_each_func);
+	google_search_each_func.named_parameters["max_results"] = LogicalType::INTEGER;
+
+	loader.RegisterFunction(google_search_each_func);
 }
 
 } // namespace duckdb
@@ -1,9 +1,85 @@
 #include "google_search_secret.hpp"
+#include "web_search_settings.hpp"
 #include "duckdb/main/secret/secret_manager.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/main/connection_manager.hpp"
+#include "duckdb/main/prepared_statement_data.hpp"
+#include "duckdb/planner/extension_callback.hpp"
 #include "duckdb/common/string_util.hpp"
+#include <atomic>
+#include <mutex>
 
 namespace duckdb {
 
+// Bumped whenever secrets may have changed (CREATE/DROP statements on any connection), which invalidates the
+// resolved configs cached by every connection
+static std::atomic<idx_t> secret_generation {0};
+
+// Resolved google_search configs of a connection, by secret name ("" = the default lookup)
+class GoogleSearchSecretCache : public ClientContextState {
+public:
+	static constexpr const char *STATE_KEY = "web_search_secret_cache";
+
+	bool Get(const string &secret_name, GoogleSearchConfig &config) {
+		lock_guard<mutex> guard(lock);
+		if (generation != secret_generation.load()) {
+			return false;
+		}
+		auto entry = configs.find(secret_name);
+		if (entry == configs.end()) {
+			return false;
+		}
+		config = entry->second;
+		return true;
+	}
+
+	void Store(idx_t lookup_generation, const string &secret_name, const GoogleSearchConfig &config) {
+		lock_guard<mutex> guard(lock);
+		if (generation != lookup_generation) {
+			configs.clear();
+			generation = lookup_generation;
+		}
+		configs[secret_name] = config;
+	}
+
+	// CREATE SECRET and DROP SECRET are CREATE/DROP statements
+	RebindQueryInfo OnFinalizePrepare(ClientContext &context, PreparedStatementData &prepared_statement,
+	                                  PreparedStatementMode mode) override {
+		if (prepared_statement.statement_type == StatementType::CREATE_STATEMENT ||
+		    prepared_statement.statement_type == StatementType::DROP_STATEMENT) {
+			secrets_changed = true;
+		}
+		return RebindQueryInfo::DO_NOT_REBIND;
+	}
+
+	// Invalidate once the statement ran, so no lookup before it can be cached as current
+	void QueryEnd(ClientContext &context) override {
+		if (secrets_changed) {
+			secrets_changed = false;
+			secret_generation++;
+		}
+	}
+
+private:
+	mutex lock;
+	bool secrets_changed = false;
+	idx_t generation = 0;
+	case_insensitive_map_t<GoogleSearchConfig> configs;
+};
+
+static void RegisterGoogleSearchSecretCache(ClientContext &context) {
+	context.registered_state->GetOrCreate<GoogleSearchSecretCache>(GoogleSearchSecretCache::STATE_KEY);
+}
+
+// Watch the statements of every connection, not only those that ran a search yet
+class GoogleSearchSecretCallback : public ExtensionCallback {
+public:
+	void OnConnectionOpened(ClientContext &context) override {
+		RegisterGoogleSearchSecretCache(context);
+	}
+};
+
 // Create a google_search secret from user input
 static unique_ptr<BaseSecret> CreateGoogleSearchSecretFunction(ClientContext &context, CreateSecretInput &input) {
 	auto scope = input.scope;
@@ -19,9 +95,13 @@ static unique_ptr<BaseSecret> CreateGoogleSearchSecretFunction(ClientContext &co
 			result->secret_map["key"] = named_param.second.ToString();
 		} else if (lower_name == "cx") {
 			result->secret_map["cx"] = named_param.second.ToString();
+		} else if (lower_name == "endpoint") {
+			auto endpoint = named_param.second.ToString();
+			ValidateSearchEndpoint(endpoint, "google_search secret endpoint");
+			result->secret_map["endpoint"] = endpoint;
 		} else {
-			throw InvalidInputException("Unknown parameter for google_search secret: '%s'. Expected: key, cx",
-			                            lower_name);
+			throw InvalidInputException(
+			    "Unknown parameter for google_search secret: '%s'. Expected: key, cx, endpoint", lower_name);
 		}
 	}
 
@@ -43,6 +123,7 @@ static unique_ptr<BaseSecret> CreateGoogleSearchSecretFunction(ClientContext &co
 static void SetGoogleSearchSecretParameters(CreateSecretFunction &function) {
 	function.named_parameters["key"] = LogicalType::VARCHAR;
 	function.named_parameters["cx"] = LogicalType::VARCHAR;
+	function.named_parameters["endpoint"] = LogicalType::VARCHAR;
 }
 
 // Register the google_search secret type
@@ -60,28 +141,27 @@ void RegisterGoogleSearchSecretType(ExtensionLoader &loader) {
 	CreateSecretFunction google_search_secret_function = {"google_search", "config", CreateGoogleSearchSecretFunction};
 	SetGoogleSearchSecretParameters(google_search_secret_function);
 	loader.RegisterFunction(google_search_secret_function);
-}
 
-// Helper function to get Google Search config from secret
-GoogleSearchConfig GetGoogleSearchConfigFromSecret(ClientContext &context) {
-	auto &secret_manager = SecretManager::Get(context);
-
-	// Try to find a google_search secret (any name)
-	auto transaction = CatalogTransaction::GetSystemCatalogTransaction(context);
-	auto secret_match = secret_manager.LookupSecret(transaction, "google_search", "google_search");
-
-	if (!secret_match.HasMatch()) {
-		throw InvalidInputException("No google_search secret found. Create one with:\n\n"
-		                            "  CREATE SECRET google_search (\n"
-		                            "    TYPE google_search,\n"
-		                            "    key 'YOUR_API_KEY',\n"
-		                            "    cx 'YOUR_SEARCH_ENGINE_ID'\n"
-		                            "  );\n\n"
-		                            "Get API key: https://developers.google.com/custom-search/v1/introduction\n"
-		                            "Create cx:   https://programmablesearchengine.google.com/controlpanel/all");
+	// Connections opened from now on get the cache through the callback, those already open (including the one
+	// running LOAD) here - otherwise their CREATE/DROP SECRET before their first search would not invalidate
+	auto &db = loader.GetDatabaseInstance();
+	DBConfig::GetConfig(db).extension_callbacks.push_back(make_uniq<GoogleSearchSecretCallback>());
+	for (auto &connection : ConnectionManager::Get(db).GetConnectionList()) {
+		RegisterGoogleSearchSecretCache(*connection);
 	}
+}
+
+static const char *const NO_GOOGLE_SEARCH_SECRET =
+    "No google_search secret found. Create one with:\n\n"
+    "  CREATE SECRET google_search (\n"
+    "    TYPE google_search,\n"
+    "    key 'YOUR_API_KEY',\n"
+    "    cx 'YOUR_SEARCH_ENGINE_ID'\n"
+    "  );\n\n"
+    "Get API key: https://developers.google.com/custom-search/v1/introduction\n"
+    "Create cx:   https://programmablesearchengine.google.com/controlpanel/all";
 
-	auto &secret = secret_match.GetSecret();
+static GoogleSearchConfig ReadGoogleSearchConfig(const BaseSecret &secret) {
 	if (secret.GetType() != "google_search") {
 		throw InvalidInputException("Secret is not a google_search secret (type is '%s')", secret.GetType());
 	}
@@ -101,7 +181,85 @@ GoogleSearchConfig GetGoogleSearchConfigFromSecret(ClientContext &context) {
 		config.cx = cx_it->second.ToString();
 	}
 
+	auto endpoint_it = kv_secret.secret_map.find("endpoint");
+	if (endpoint_it != kv_secret.secret_map.end()) {
+		config.endpoint = endpoint_it->second.ToString();
+	}
+
+	return config;
+}
+
+// Look the secret up in the secret manager
+static GoogleSearchConfig LookupGoogleSearchConfig(ClientContext &context, const string &secret_name) {
+	auto &secret_manager = SecretManager::Get(context);
+	auto transaction = CatalogTransaction::GetSystemCatalogTransaction(context);
+
+	if (secret_name.empty()) {
+		// Try to find a google_search secret (any name)
+		auto secret_match = secret_manager.LookupSecret(transaction, "google_search", "google_search");
+		if (!secret_match.HasMatch()) {
+			throw InvalidInputException(NO_GOOGLE_SEARCH_SECRET);
+		}
+		return ReadGoogleSearchConfig(secret_match.GetSecret());
+	}
+
+	// By name, else a secret created with that SCOPE
+	auto entry = secret_manager.GetSecretByName(transaction, secret_name);
+	if (entry) {
+		return ReadGoogleSearchConfig(*entry->secret);
+	}
+	// An unscoped secret matches any scope - only take a secret that was scoped to it
+	auto secret_match = secret_manager.LookupSecret(transaction, secret_name, "google_search");
+	bool scoped = false;
+	if (secret_match.HasMatch()) {
+		for (auto &prefix : secret_match.GetSecret().GetScope()) {
+			scoped = scoped || (!prefix.empty() && StringUtil::StartsWith(secret_name, prefix));
+		}
+	}
+	if (!scoped) {
+		throw InvalidInputException("No google_search secret named '%s' or with scope '%s' found", secret_name,
+		                            secret_name);
+	}
+	return ReadGoogleSearchConfig(secret_match.GetSecret());
+}
+
+GoogleSearchConfig GetGoogleSearchConfigFromSecret(ClientContext &context, const string &secret_name) {
+	auto cache = context.registered_state->GetOrCreate<GoogleSearchSecretCache>(GoogleSearchSecretCache::STATE_KEY);
+	GoogleSearchConfig config;
+	if (cache->Get(secret_name, config)) {
+		return config;
+	}
+
+	// Read before the lookup, so a change during it invalidates what is stored
+	auto generation = secret_generation.load();
+	config = LookupGoogleSearchConfig(context, secret_name);
+	cache->Store(generation, secret_name, config);
 	return config;
 }
 
+vector<GoogleSearchConfig> GetGoogleSearchConfigsFromSecrets(ClientContext &context,
+                                                             const named_parameter_map_t &parameters) {
+	vector<GoogleSearchConfig> configs;
+	for (auto &kv : parameters) {
+		auto name = StringUtil::Lower(kv.first);
+		if (kv.second.IsNull()) {
+			continue;
+		}
+		if (name == "secret") {
+			configs.push_back(GetGoogleSearchConfigFromSecret(context, kv.second.GetValue<string>()));
+		} else if (name == "secrets") {
+			for (auto &secret_name : ListValue::GetChildren(kv.second)) {
+				if (secret_name.IsNull()) {
+					throw InvalidInputException("secrets must not contain NULL");
+				}
+				configs.push_back(GetGoogleSearchConfigFromSecret(context, secret_name.GetValue<string>()));
+			}
+		}
+	}
+	if (configs.empty()) {
+		configs.push_back(GetGoogleSearchConfigFromSecret(context));
+	}
+	return configs;
+}
+
 } // namespace duckdb
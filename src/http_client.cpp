@@ -1,32 +1,66 @@
 #include "http_client.hpp"
-#include "duckdb/main/connection.hpp"
+#include "interruptible_wait.hpp"
+#include "rate_limiter.hpp"
+#include "response_cache.hpp"
+#include "retry_timer_queue.hpp"
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/gzip_file_system.hpp"
+#include "duckdb/common/http_util.hpp"
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 #include <chrono>
 #include <cmath>
-#include <sstream>
-#include <iomanip>
+#include <algorithm>
+#include <random>
+#include <array>
 
 namespace duckdb {
 
-std::string UrlEncode(const std::string &value) {
-	std::ostringstream escaped;
-	escaped.fill('0');
-	escaped << std::hex;
+// Characters kept as they are by UrlEncode: alphanumerics and -_.~
+static const std::array<bool, 256> URL_UNRESERVED = [] {
+	std::array<bool, 256> unreserved {};
+	for (int c = 0; c < 256; c++) {
+		unreserved[c] = isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~';
+	}
+	return unreserved;
+}();
+
+void AppendUrlEncoded(std::string &out, const std::string &value) {
+	static constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
 
+	// Written in place into the worst case size, then cut to what was written
+	auto old_size = out.size();
+	out.resize(old_size + value.size() * 3);
+	auto target = &out[old_size];
 	for (char c : value) {
-		// Keep alphanumeric and other safe characters intact
-		if (isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.' || c == '~') {
-			escaped << c;
+		auto byte = static_cast<unsigned char>(c);
+		if (URL_UNRESERVED[byte]) {
+			*target++ = c;
 		} else {
-			// Any other characters are percent-encoded
-			escaped << std::uppercase;
-			escaped << '%' << std::setw(2) << int(static_cast<unsigned char>(c));
-			escaped << std::nouppercase;
+			target[0] = '%';
+			target[1] = HEX_DIGITS[byte >> 4];
+			target[2] = HEX_DIGITS[byte & 0xF];
+			target += 3;
 		}
 	}
+	out.resize(target - out.data());
+}
+
+void AppendUrlParameter(std::string &url, const char *name, const std::string &value) {
+	url += '&';
+	url += name;
+	url += '=';
+	AppendUrlEncoded(url, value);
+}
 
-	return escaped.str();
+std::string UrlEncode(const std::string &value) {
+	std::string escaped;
+	AppendUrlEncoded(escaped, value);
+	return escaped;
 }
 
 bool HttpClient::IsRetryable(int status_code) {
@@ -59,108 +93,670 @@ int HttpClient::ParseRetryAfter(const std::string &retry_after) {
 	}
 }
 
-HttpResponse HttpClient::ExecuteHttpGet(DatabaseInstance &db, const std::string &url) {
-	HttpResponse response;
+// Idle keep-alive connections grouped by scheme://host:port. One pool lives in the object cache of each
+// DatabaseInstance, so the TCP connection and its TLS session survive across pages, queries and connections.
+class HttpConnectionPool : public ObjectCacheEntry {
+public:
+	static constexpr idx_t MAX_IDLE_PER_HOST = 16;
 
-	Connection conn(db);
+	static string ObjectType() {
+		return "web_search_http_connection_pool";
+	}
 
-	// Load http_request in this connection
-	auto load_result = conn.Query("LOAD http_request");
-	if (load_result->HasError()) {
-		response.error = "Failed to load http_request extension. Install it with: INSTALL http_request FROM community";
-		return response;
+	string GetObjectType() override {
+		return ObjectType();
 	}
 
-	// Escape URL for SQL
-	std::string escaped_url = StringUtil::Replace(url, "'", "''");
+	unique_ptr<HTTPClient> Acquire(HTTPUtil &http_util, HTTPParams &params, const string &proto_host_port) {
+		unique_ptr<HTTPClient> client;
+		{
+			lock_guard<mutex> guard(lock);
+			auto &idle = idle_clients[proto_host_port];
+			if (!idle.empty()) {
+				client = std::move(idle.back());
+				idle.pop_back();
+			}
+		}
+		if (client) {
+			// Refresh timeouts/proxy settings - they may have changed since the connection was opened
+			client->Initialize(params);
+			return client;
+		}
+		return http_util.InitializeClient(params, proto_host_port);
+	}
+
+	void Release(const string &proto_host_port, unique_ptr<HTTPClient> client) {
+		lock_guard<mutex> guard(lock);
+		auto &idle = idle_clients[proto_host_port];
+		if (idle.size() < MAX_IDLE_PER_HOST) {
+			idle.push_back(std::move(client));
+		}
+	}
+
+private:
+	mutex lock;
+	unordered_map<string, vector<unique_ptr<HTTPClient>>> idle_clients;
+};
+
+// A GET prepared on the calling thread: running it does not touch the ClientContext, so it can run on another
+// thread and finish after the query (a hedged request that lost the race)
+struct PreparedHttpGet {
+	shared_ptr<DatabaseInstance> db; // Keeps HTTPUtil and the pool's owner alive
+	shared_ptr<HttpConnectionPool> pool;
+	unique_ptr<HTTPParams> params;
+	std::string url;
+	string proto_host_port;
+};
 
-	// Build query with gzip compression for smaller responses
-	// See: https://developers.google.com/custom-search/v1/performance#gzip
-	// Note: use struct syntax {'k':'v'} not MAP - MAP causes segfault
-	std::string query = StringUtil::Format("SELECT status, decode(body) AS body, "
-	                                       "content_type, "
-	                                       "headers['retry-after'] AS retry_after "
-	                                       "FROM http_get('%s', headers := {'Accept-Encoding': 'gzip'})",
-	                                       escaped_url);
+static unique_ptr<PreparedHttpGet> PrepareHttpGet(ClientContext &context, const std::string &url) {
+	auto request = make_uniq<PreparedHttpGet>();
+	request->db = context.db;
+	request->pool =
+	    ObjectCache::GetObjectCache(context).GetOrCreate<HttpConnectionPool>(HttpConnectionPool::ObjectType());
+	request->params = HTTPUtil::Get(*request->db).InitializeParameters(context, url);
+	request->params->keep_alive = true;
+	request->url = url;
+	string path;
+	HTTPUtil::DecomposeURL(url, path, request->proto_host_port);
+	return request;
+}
+
+static HttpResponse RunHttpGet(PreparedHttpGet &prepared) {
+	HttpResponse response;
+	auto &http_util = HTTPUtil::Get(*prepared.db);
+	auto &params = *prepared.params;
+	auto &proto_host_port = prepared.proto_host_port;
+	auto &pool = prepared.pool;
 
-	auto result = conn.Query(query);
+	// Ask for gzip - see: https://developers.google.com/custom-search/v1/performance#gzip
+	HTTPHeaders headers;
+	headers.Insert("Accept-Encoding", "gzip");
+	GetRequestInfo request(prepared.url, headers, params, nullptr, nullptr);
 
-	if (result->HasError()) {
-		response.error = result->GetError();
-		response.status_code = 0;
+	unique_ptr<HTTPClient> client;
+	unique_ptr<HTTPResponse> http_response;
+	try {
+		client = pool->Acquire(http_util, params, proto_host_port);
+		http_response = client->Get(request);
+	} catch (std::exception &ex) {
+		// Connection is in an unknown state - drop it instead of returning it to the pool
+		response.error = ex.what();
 		return response;
 	}
 
-	auto chunk = result->Fetch();
-	if (!chunk || chunk->size() == 0) {
-		response.error = "No response from HTTP request";
-		response.status_code = 0;
+	if (!http_response || http_response->HasRequestError()) {
+		response.error = http_response ? http_response->GetRequestError() : "No response from HTTP request";
 		return response;
 	}
 
-	// Get status code
-	auto status_val = chunk->GetValue(0, 0);
-	response.status_code = status_val.IsNull() ? 0 : status_val.GetValue<int>();
-
-	// Get body
-	auto body_val = chunk->GetValue(1, 0);
-	response.body = body_val.IsNull() ? "" : body_val.GetValue<std::string>();
+	response.status_code = static_cast<int>(http_response->status);
+	response.body = std::move(http_response->body);
+	response.wire_size = response.body.size();
+	if (http_response->HasHeader("Content-Type")) {
+		response.content_type = http_response->GetHeaderValue("Content-Type");
+	}
+	if (http_response->HasHeader("Retry-After")) {
+		response.retry_after = http_response->GetHeaderValue("Retry-After");
+	}
 
-	// Get content-type
-	auto ct_val = chunk->GetValue(2, 0);
-	response.content_type = ct_val.IsNull() ? "" : ct_val.GetValue<std::string>();
+	bool keep_connection = true;
+	if (http_response->HasHeader("Connection")) {
+		keep_connection = !StringUtil::CIEquals(http_response->GetHeaderValue("Connection"), "close");
+	}
+	if (keep_connection) {
+		pool->Release(proto_host_port, std::move(client));
+	}
 
-	// Get retry-after
-	auto ra_val = chunk->GetValue(3, 0);
-	response.retry_after = ra_val.IsNull() ? "" : ra_val.GetValue<std::string>();
+	// Decode gzip in-process
+	if (http_response->HasHeader("Content-Encoding") &&
+	    StringUtil::CIEquals(http_response->GetHeaderValue("Content-Encoding"), "gzip")) {
+		try {
+			response.body = GZipFileSystem::UncompressGZIPString(response.body);
+		} catch (std::exception &ex) {
+			response.error = string("Failed to decompress gzip response: ") + ex.what();
+			response.status_code = 0;
+			return response;
+		}
+	}
 
 	response.success = (response.status_code >= 200 && response.status_code < 300);
 	return response;
 }
 
-HttpResponse HttpClient::Fetch(ClientContext &context, const std::string &url, const RetryConfig &config) {
-	auto &db = DatabaseInstance::GetDatabase(context);
+HttpResponse HttpClient::ExecuteHttpGet(ClientContext &context, const std::string &url) {
+	auto request = PrepareHttpGet(context, url);
+	return RunHttpGet(*request);
+}
 
-	for (int attempt = 0; attempt <= config.max_retries; attempt++) {
-		auto response = ExecuteHttpGet(db, url);
+// Recent response times of the process, for the hedging delay
+class HedgeLatencyTracker {
+public:
+	static constexpr idx_t WINDOW = 256;
+	static constexpr idx_t MIN_SAMPLES = 20;
 
-		if (response.success) {
-			return response;
+	static HedgeLatencyTracker &Get() {
+		static HedgeLatencyTracker instance;
+		return instance;
+	}
+
+	void Record(double elapsed_ms) {
+		lock_guard<mutex> guard(lock);
+		if (samples.size() < WINDOW) {
+			samples.push_back(elapsed_ms);
+		} else {
+			samples[next_sample] = elapsed_ms;
 		}
+		next_sample = (next_sample + 1) % WINDOW;
+	}
 
-		// Check if we should retry
-		if (!IsRetryable(response.status_code)) {
-			return response; // Non-retryable error
+	// The percentile of the recent response times, or a negative value while there are too few samples
+	double Percentile(double percentile) {
+		vector<double> sorted;
+		{
+			lock_guard<mutex> guard(lock);
+			if (samples.size() < MIN_SAMPLES) {
+				return -1;
+			}
+			sorted = samples;
 		}
+		auto rank = MinValue<idx_t>(static_cast<idx_t>(percentile / 100.0 * static_cast<double>(sorted.size())),
+		                            sorted.size() - 1);
+		std::nth_element(sorted.begin(), sorted.begin() + static_cast<int64_t>(rank), sorted.end());
+		return sorted[rank];
+	}
 
-		// Check if we've exhausted retries
-		if (attempt >= config.max_retries) {
-			response.error = "Max retries exceeded for URL: " + url;
-			return response;
+private:
+	mutex lock;
+	vector<double> samples;
+	idx_t next_sample = 0;
+};
+
+// A request and its hedge, raced: both run on threads of their own, and the caller takes the first successful
+// response. The loser is abandoned - its thread is detached and only holds the race and its prepared request, so it
+// may finish after the query.
+struct HedgeRace {
+	mutex lock;
+	std::condition_variable done_cv;
+	bool finished = false; // The caller returned: a hedge not sent yet is not sent anymore
+	bool primary_done = false;
+	HttpResponse primary_response;
+	bool hedge_sent = false;
+	bool hedge_done = false;
+	HttpResponse hedge_response;
+
+	// Prepared on the calling thread, so sending the hedge does not touch the ClientContext
+	unique_ptr<PreparedHttpGet> hedge_request;
+	RateLimitSettings limits;
+	WebSearchScanStats *stats = nullptr; // Only used before finished is set, while the scan is still waiting
+
+	// A successful response is in, or no success can come anymore
+	bool Decided() const {
+		if ((primary_done && primary_response.success) || (hedge_done && hedge_response.success)) {
+			return true;
 		}
+		return primary_done && (!hedge_sent || hedge_done);
+	}
+};
 
-		// Calculate wait time
-		int wait_ms;
-		if (response.status_code == 429 && !response.retry_after.empty()) {
-			wait_ms = ParseRetryAfter(response.retry_after);
-			if (wait_ms <= 0) {
-				wait_ms = static_cast<int>(config.initial_backoff_ms * std::pow(config.backoff_multiplier, attempt));
+// Run one side of the race on a detached thread
+static void StartHedgeRaceRequest(shared_ptr<HedgeRace> race, shared_ptr<PreparedHttpGet> request, bool hedge) {
+	std::thread([race, request, hedge]() {
+		HttpResponse response;
+		try {
+			response = RunHttpGet(*request);
+		} catch (std::exception &ex) {
+			response.error = ex.what();
+		}
+		lock_guard<mutex> guard(race->lock);
+		(hedge ? race->hedge_response : race->primary_response) = std::move(response);
+		(hedge ? race->hedge_done : race->primary_done) = true;
+		race->done_cv.notify_all();
+	}).detach();
+}
+
+// Sends the hedges that are due, from one process-wide timer thread: a hedge's thread is only started once its
+// delay passed without a response
+class HedgeScheduler {
+public:
+	static HedgeScheduler &Get() {
+		static HedgeScheduler instance;
+		return instance;
+	}
+
+	~HedgeScheduler() {
+		{
+			lock_guard<mutex> guard(lock);
+			shutdown = true;
+		}
+		wakeup.notify_all();
+		if (timer_thread.joinable()) {
+			timer_thread.join();
+		}
+	}
+
+	void Schedule(shared_ptr<HedgeRace> race, int delay_ms) {
+		{
+			lock_guard<mutex> guard(lock);
+			if (!timer_thread.joinable()) {
+				timer_thread = std::thread([this]() { Run(); });
 			}
-		} else {
-			wait_ms = static_cast<int>(config.initial_backoff_ms * std::pow(config.backoff_multiplier, attempt));
+			pending.Push(std::move(race), delay_ms);
 		}
+		wakeup.notify_all();
+	}
 
-		// Cap at max backoff
-		wait_ms = std::min(wait_ms, config.max_backoff_ms);
+private:
+	void Run() {
+		std::unique_lock<mutex> guard(lock);
+		while (!shutdown) {
+			shared_ptr<HedgeRace> race;
+			if (pending.PopDue(race)) {
+				guard.unlock();
+				Send(*race, race);
+				guard.lock();
+			} else if (pending.Empty()) {
+				wakeup.wait(guard);
+			} else {
+				wakeup.wait_until(guard, pending.NextDue());
+			}
+		}
+	}
+
+	static void Send(HedgeRace &race, const shared_ptr<HedgeRace> &race_ref) {
+		lock_guard<mutex> guard(race.lock);
+		// A primary answered or failed meanwhile: a failure is retried by the caller's schedule instead
+		if (race.finished || race.primary_done ||
+		    !ApiRateLimiter::TryAcquireHedge(race.limits, race.hedge_request->url)) {
+			return;
+		}
+		if (race.stats) {
+			race.stats->hedges++;
+			race.stats->requests++;
+		}
+		WebSearchProcessStats::Add(WebSearchProcessStats::Get().hedges);
+		WebSearchProcessStats::Add(WebSearchProcessStats::Get().requests);
+		race.hedge_sent = true;
+		StartHedgeRaceRequest(race_ref, std::move(race.hedge_request), true);
+	}
+
+	mutex lock;
+	std::condition_variable wakeup;
+	RetryTimerQueue<shared_ptr<HedgeRace>> pending;
+	bool shutdown = false;
+	std::thread timer_thread;
+};
+
+static double GetHedgePercentile(ClientContext &context) {
+	Value value;
+	if (context.TryGetCurrentSetting("web_search_hedge_percentile", value) && !value.IsNull()) {
+		return value.GetValue<double>();
+	}
+	return 0;
+}
 
-		// Wait before retry
-		std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms));
+// DuckDB's http_timeout (seconds): how long either request of a race may take
+static std::chrono::milliseconds GetHttpTimeout(ClientContext &context) {
+	Value value;
+	if (context.TryGetCurrentSetting("http_timeout", value) && !value.IsNull()) {
+		return std::chrono::milliseconds(value.GetValue<int64_t>() * 1000);
 	}
+	return std::chrono::milliseconds(30000);
+}
+
+// Wait for the first successful response of the race, else the primary's failure (or the hedge's, if it was sent).
+// deadline: both requests are over by then, each being bounded by http_timeout.
+static HttpResponse AwaitHedgeRace(ClientContext &context, HedgeRace &race,
+                                   std::chrono::steady_clock::time_point deadline) {
+	std::unique_lock<mutex> guard(race.lock);
+	bool decided;
+	try {
+		decided = WaitUntilInterruptible(context, race.done_cv, guard, deadline, [&] { return race.Decided(); });
+	} catch (...) {
+		race.finished = true;
+		throw;
+	}
+	race.finished = true;
+	if (race.primary_done && race.primary_response.success) {
+		return std::move(race.primary_response);
+	}
+	if (race.hedge_done && race.hedge_response.success) {
+		return std::move(race.hedge_response);
+	}
+	if (!decided) {
+		HttpResponse timed_out;
+		timed_out.error = "HTTP request timed out (http_timeout)";
+		return timed_out;
+	}
+	return std::move(race.primary_done ? race.primary_response : race.hedge_response);
+}
 
-	// Should not reach here, but just in case
+HttpResponse HttpClient::ExecuteHedgedHttpGet(ClientContext &context, const std::string &url,
+                                              WebSearchScanStats *stats) {
+	auto start = std::chrono::steady_clock::now();
+	auto percentile = GetHedgePercentile(context);
+	auto hedge_delay_ms = percentile > 0 ? HedgeLatencyTracker::Get().Percentile(percentile) : -1;
+
+	HttpResponse response;
+	if (hedge_delay_ms < 0) {
+		response = ExecuteHttpGet(context, url);
+	} else {
+		auto race = make_shared_ptr<HedgeRace>();
+		race->hedge_request = PrepareHttpGet(context, url);
+		race->limits = RateLimitSettings::FromContext(context);
+		race->stats = stats;
+		auto delay_ms = static_cast<int>(std::ceil(hedge_delay_ms));
+		StartHedgeRaceRequest(race, PrepareHttpGet(context, url), false);
+		HedgeScheduler::Get().Schedule(race, delay_ms);
+		auto deadline = start + std::chrono::milliseconds(delay_ms) + GetHttpTimeout(context);
+		response = AwaitHedgeRace(context, *race, deadline);
+	}
+
+	if (percentile > 0 && response.success) {
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		HedgeLatencyTracker::Get().Record(elapsed.count());
+	}
+	return response;
+}
+
+// Fetches of the same URL that overlap in time share one request: the first caller fetches, the others wait for its
+// response. Process-wide, so concurrent queries (e.g. a dashboard refresh) spend the quota once.
+class SingleFlightFetches {
+public:
+	static SingleFlightFetches &Get() {
+		static SingleFlightFetches instance;
+		return instance;
+	}
+
+	template <class FETCH>
+	HttpResponse Fetch(const std::string &url, WebSearchScanStats *stats, FETCH &&fetch) {
+		shared_ptr<Call> call;
+		bool leader = false;
+		{
+			lock_guard<mutex> guard(lock);
+			auto &entry = calls[url];
+			if (!entry) {
+				entry = make_shared_ptr<Call>();
+				leader = true;
+			}
+			call = entry;
+		}
+
+		if (!leader) {
+			if (stats) {
+				stats->coalesced++;
+			}
+			WebSearchProcessStats::Add(WebSearchProcessStats::Get().coalesced);
+			std::unique_lock<mutex> call_guard(call->lock);
+			call->done_cv.wait(call_guard, [&] { return call->done; });
+			if (call->error.HasError()) {
+				call->error.Throw();
+			}
+			return call->response;
+		}
+
+		HttpResponse response;
+		ErrorData error;
+		try {
+			response = fetch();
+		} catch (std::exception &ex) {
+			error = ErrorData(ex);
+		}
+		{
+			// Later callers start a new fetch (and find the response cache filled)
+			lock_guard<mutex> guard(lock);
+			calls.erase(url);
+		}
+		{
+			lock_guard<mutex> call_guard(call->lock);
+			call->response = response;
+			call->error = error;
+			call->done = true;
+		}
+		call->done_cv.notify_all();
+		if (error.HasError()) {
+			error.Throw();
+		}
+		return response;
+	}
+
+private:
+	struct Call {
+		mutex lock;
+		std::condition_variable done_cv;
+		bool done = false;
+		HttpResponse response;
+		ErrorData error;
+	};
+
+	mutex lock;
+	unordered_map<std::string, shared_ptr<Call>> calls;
+};
+
+RetryConfig RetryConfig::FromContext(ClientContext &context) {
+	RetryConfig config;
+	Value value;
+	if (context.TryGetCurrentSetting("web_search_max_retries", value) && !value.IsNull()) {
+		config.max_retries = static_cast<int>(value.GetValue<int64_t>());
+	}
+	if (context.TryGetCurrentSetting("web_search_initial_backoff_ms", value) && !value.IsNull()) {
+		config.initial_backoff_ms = static_cast<int>(value.GetValue<int64_t>());
+	}
+	if (context.TryGetCurrentSetting("web_search_backoff_multiplier", value) && !value.IsNull()) {
+		config.backoff_multiplier = value.GetValue<double>();
+	}
+	if (context.TryGetCurrentSetting("web_search_max_backoff_ms", value) && !value.IsNull()) {
+		config.max_backoff_ms = static_cast<int>(value.GetValue<int64_t>());
+	}
+	return config;
+}
+
+int HttpClient::RetryDelayMs(const RetryConfig &config, int attempt, const HttpResponse &response) {
+	if (response.status_code == 429 && !response.retry_after.empty()) {
+		int wait_ms = ParseRetryAfter(response.retry_after);
+		if (wait_ms > 0) {
+			return std::min(wait_ms, config.max_backoff_ms);
+		}
+	}
+	// Exponential backoff, with a random point in its upper half so that pages that failed together don't retry
+	// together
+	double backoff = std::min(config.initial_backoff_ms * std::pow(config.backoff_multiplier, attempt),
+	                          static_cast<double>(config.max_backoff_ms));
+	static thread_local std::mt19937 engine(std::random_device {}());
+	std::uniform_real_distribution<double> jitter(0.5, 1.0);
+	return static_cast<int>(backoff * jitter(engine));
+}
+
+FetchAttempt HttpClient::TryFetch(ClientContext &context, const std::string &url, const RetryConfig &config,
+                                  int attempt, WebSearchScanStats *stats) {
+	FetchAttempt result;
+	result.response = SingleFlightFetches::Get().Fetch(
+	    url, stats, [&]() { return FetchOnce(context, url, attempt == 0, attempt > 0, stats); });
+
+	auto &response = result.response;
+	if (response.throttle_ms > 0) {
+		result.retry = true;
+		result.retry_delay_ms = response.throttle_ms;
+		result.throttled = true;
+		return result;
+	}
+	if (response.success || !response.retryable) {
+		return result;
+	}
+	if (attempt >= config.max_retries) {
+		// The URL contains the API key
+		response.error = "Max retries exceeded for URL: " + ResponseCache::NormalizeUrl(url);
+		return result;
+	}
+	result.retry = true;
+	result.retry_delay_ms = RetryDelayMs(config, attempt, response);
+	if (stats) {
+		stats->backoff_ms += result.retry_delay_ms;
+	}
+	auto &process_stats = WebSearchProcessStats::Get();
+	WebSearchProcessStats::AddStatus(process_stats.retries_by_status, response.status_code);
+	WebSearchProcessStats::Add(process_stats.backoff_ms, result.retry_delay_ms);
+	return result;
+}
+
+HttpResponse HttpClient::FetchOnce(ClientContext &context, const std::string &url, bool use_cache, bool is_retry,
+                                   WebSearchScanStats *stats) {
+	auto cache_config = ResponseCacheConfig::FromContext(context);
+	auto &process_stats = WebSearchProcessStats::Get();
+	if (use_cache &&
+	    (cache_config.mode == ResponseCacheMode::READ_THROUGH || cache_config.mode == ResponseCacheMode::CACHE_ONLY)) {
+		HttpResponse cached;
+		if (ResponseCache::TryGet(context, cache_config, url, cached.body)) {
+			cached.status_code = 200;
+			cached.content_type = "application/json";
+			cached.success = true;
+			if (stats) {
+				stats->cache_hits++;
+			}
+			WebSearchProcessStats::Add(process_stats.response_cache_hits);
+			return cached;
+		}
+		WebSearchProcessStats::Add(process_stats.response_cache_misses);
+		if (cache_config.mode == ResponseCacheMode::CACHE_ONLY) {
+			HttpResponse miss;
+			miss.status_code = 504;
+			miss.error = "Response for '" + ResponseCache::NormalizeUrl(url) +
+			             "' is not in the web_search cache (web_search_cache_mode = 'cache_only')";
+			return miss;
+		}
+	}
+
+	// Every attempt is a request against the quota
+	int throttle_ms = 0;
+	auto rate_limit = ApiRateLimiter::Acquire(context, url, throttle_ms);
+	if (rate_limit == RateLimitResult::THROTTLED) {
+		HttpResponse throttled;
+		throttled.throttle_ms = throttle_ms;
+		return throttled;
+	}
+	if (rate_limit == RateLimitResult::QUOTA_EXHAUSTED) {
+		HttpResponse exhausted;
+		exhausted.quota_exhausted = true;
+		exhausted.error = StringUtil::Format("Google Search API: daily request budget of %d exhausted for this API key "
+		                                     "(web_search_daily_quota)",
+		                                     RateLimitSettings::FromContext(context).daily_quota);
+		return exhausted;
+	}
 	HttpResponse response;
-	response.error = "Unexpected error in HTTP fetch";
+	{
+		ScanStatsTimer timer(stats ? &stats->network_us : nullptr, &process_stats.network_us);
+		response = ExecuteHedgedHttpGet(context, url, stats);
+	}
+	if (stats) {
+		stats->requests++;
+		stats->retries += is_retry ? 1 : 0;
+		stats->bytes += response.body.size();
+		stats->wire_bytes += response.wire_size;
+	}
+	WebSearchProcessStats::Add(process_stats.requests);
+	WebSearchProcessStats::Add(process_stats.retries, is_retry ? 1 : 0);
+	WebSearchProcessStats::Add(process_stats.bytes, response.body.size());
+	WebSearchProcessStats::Add(process_stats.wire_bytes, response.wire_size);
+	WebSearchProcessStats::AddStatus(process_stats.responses_by_status, response.status_code);
+	response.retryable = !response.success && IsRetryable(response.status_code);
+	if (response.status_code == 429) {
+		ApiRateLimiter::RecordRateLimited(context, url);
+	}
+
+	if (response.success && cache_config.mode != ResponseCacheMode::OFF) {
+		// A full disk or read-only cache directory must not fail the query
+		try {
+			ResponseCache::Put(context, cache_config, url, response.body);
+		} catch (std::exception &) {
+		}
+	}
 	return response;
 }
 
+void RunConcurrently(idx_t task_count, idx_t max_concurrency, const std::function<void(idx_t)> &task) {
+	std::atomic<idx_t> next_idx(0);
+	mutex error_lock;
+	ErrorData error;
+
+	auto worker = [&]() {
+		while (true) {
+			idx_t idx = next_idx++;
+			if (idx >= task_count) {
+				return;
+			}
+			// Exceptions must not escape a worker thread
+			try {
+				task(idx);
+			} catch (std::exception &ex) {
+				lock_guard<mutex> guard(error_lock);
+				if (!error.HasError()) {
+					error = ErrorData(ex);
+				}
+			}
+		}
+	};
+
+	idx_t worker_count = MinValue<idx_t>(MaxValue<idx_t>(max_concurrency, 1), task_count);
+	vector<std::thread> threads;
+	for (idx_t i = 1; i < worker_count; i++) {
+		threads.emplace_back(worker);
+	}
+	worker();
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	if (error.HasError()) {
+		error.Throw();
+	}
+}
+
+vector<HttpResponse> HttpClient::FetchAll(ClientContext &context, const vector<std::string> &urls,
+                                         const RetryConfig &config, idx_t max_concurrency) {
+	vector<HttpResponse> responses(urls.size());
+	mutex lock;
+	std::condition_variable retry_due;
+	idx_t next_idx = 0;
+	// (URL index, attempt) of the fetches waiting for their backoff
+	RetryTimerQueue<std::pair<idx_t, int>> retries;
+
+	// A worker fetches the next due retry or the next URL, and only waits when neither is available
+	auto worker = [&](idx_t) {
+		std::unique_lock<mutex> guard(lock);
+		while (true) {
+			std::pair<idx_t, int> task;
+			if (!retries.PopDue(task)) {
+				if (next_idx < urls.size()) {
+					task = std::make_pair(next_idx++, 0);
+				} else if (!retries.Empty()) {
+					// Wake up at least every INTERRUPT_CHECK_INTERVAL to check for an interrupt
+					CheckInterrupted(context);
+					retry_due.wait_until(guard, MinValue(retries.NextDue(), std::chrono::steady_clock::now() +
+					                                                             INTERRUPT_CHECK_INTERVAL));
+					continue;
+				} else {
+					return;
+				}
+			}
+			guard.unlock();
+			FetchAttempt attempt;
+			try {
+				attempt = TryFetch(context, urls[task.first], config, task.second);
+			} catch (std::exception &ex) {
+				attempt.response.error = ex.what();
+			}
+			guard.lock();
+			if (attempt.retry) {
+				auto next_attempt = attempt.throttled ? task.second : task.second + 1;
+				retries.Push(std::make_pair(task.first, next_attempt), attempt.retry_delay_ms);
+				retry_due.notify_one();
+			} else {
+				responses[task.first] = std::move(attempt.response);
+			}
+		}
+	};
+	auto worker_count = MinValue<idx_t>(MaxValue<idx_t>(max_concurrency, 1), urls.size());
+	RunConcurrently(worker_count, worker_count, worker);
+	return responses;
+}
+
 } // namespace duckdb
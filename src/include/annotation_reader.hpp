@@ -0,0 +1,46 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/function/copy_function.hpp"
+
+namespace duckdb {
+
+// One <Annotation> element
+struct PseAnnotation {
+	string url_pattern;
+	string action; // include/exclude for the _include_/_exclude_ labels, else the label name
+	string comment;
+	bool has_comment = false;
+	double score = 0;
+	bool has_score = false;
+};
+
+// Streaming reader of a Google PSE annotation XML file: one element is buffered at a time, not the whole document
+class PseAnnotationReader {
+public:
+	PseAnnotationReader(unique_ptr<FileHandle> handle, string path);
+
+	// Read the next annotation, false at the end of the file
+	bool Next(PseAnnotation &annotation);
+
+private:
+	// Read more of the file into the buffer, false at the end of the file
+	bool Fill();
+	void ParseAnnotation(const char *data, idx_t size, PseAnnotation &annotation);
+
+	unique_ptr<FileHandle> handle;
+	string path;
+	string buffer;
+	idx_t pos = 0;
+	bool eof = false;
+};
+
+// read_pse_annotations(path): (url_pattern, action, comment, score) rows, path can be a glob (e.g. PER_FILE shards)
+TableFunction GetReadPseAnnotationsFunction();
+void RegisterReadPseAnnotationsFunction(ExtensionLoader &loader);
+
+// COPY tbl FROM 'annotations.xml' (FORMAT google_pse_annotation): the table's columns by position
+unique_ptr<FunctionData> AnnotationCopyFromBind(ClientContext &context, CopyFromFunctionBindInput &input,
+                                                vector<string> &expected_names, vector<LogicalType> &expected_types);
+
+} // namespace duckdb
@@ -10,6 +10,9 @@ void RegisterGoogleImageSearchFunction(ExtensionLoader &loader);
 // LIMIT pushdown optimizer for google_image_search
 void OptimizeGoogleImageSearchLimitPushdown(unique_ptr<LogicalOperator> &op);
 
+// ORDER BY pushdown optimizer for google_image_search
+void OptimizeGoogleImageSearchOrderByPushdown(unique_ptr<LogicalOperator> &op);
+
 // Image-specific filters
 struct GoogleImageSearchFilters {
 	// Inherited from base search
@@ -19,6 +22,7 @@ struct GoogleImageSearchFilters {
 	string site_search;
 	string safe;
 	string rights;
+	string sort;
 
 	// Image-specific
 	string img_size;           // imgSize: huge/icon/large/medium/small/xlarge/xxlarge
@@ -10,10 +10,15 @@ void RegisterGoogleSearchSecretType(ExtensionLoader &loader);
 // Config structure for Google Search API
 struct GoogleSearchConfig {
 	string api_key;
-	string cx; // Search engine ID
+	string cx;       // Search engine ID
+	string endpoint; // API endpoint of this secret, empty for web_search_endpoint
 };
 
-// Helper to get config from secret
-GoogleSearchConfig GetGoogleSearchConfigFromSecret(ClientContext &context);
+// Helper to get config from secret: the named secret (or the secret with that SCOPE), else any google_search secret.
+// Resolved configs are cached per connection until secrets are created or dropped.
+GoogleSearchConfig GetGoogleSearchConfigFromSecret(ClientContext &context, const string &secret_name = "");
+// The secrets of a search: secret := and secrets := [...] (names or scopes), else any google_search secret
+vector<GoogleSearchConfig> GetGoogleSearchConfigsFromSecrets(ClientContext &context,
+                                                             const named_parameter_map_t &parameters);
 
 } // namespace duckdb
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "duckdb.hpp"
+#include "scan_stats.hpp"
+#include <functional>
 #include <string>
 
 namespace duckdb {
@@ -8,10 +10,14 @@ namespace duckdb {
 struct HttpResponse {
 	int status_code = 0;
 	std::string body;
+	idx_t wire_size = 0; // Body size as received, before gzip decoding
 	std::string content_type;
 	std::string retry_after;
 	std::string error;
 	bool success = false;
+	bool retryable = false;       // Failed with a 429, 5xx or network error
+	bool quota_exhausted = false; // Not sent: the key's web_search_daily_quota is used up
+	int throttle_ms = 0;          // Not sent: no web_search_max_qps token for this long
 };
 
 struct RetryConfig {
@@ -19,19 +25,56 @@ struct RetryConfig {
 	int initial_backoff_ms = 100;
 	double backoff_multiplier = 2.0;
 	int max_backoff_ms = 10000;
+
+	// From the web_search_max_retries, web_search_initial_backoff_ms, web_search_backoff_multiplier and
+	// web_search_max_backoff_ms settings
+	static RetryConfig FromContext(ClientContext &context);
+};
+
+// Outcome of one fetch attempt: a final response, or a retry to schedule after retry_delay_ms
+struct FetchAttempt {
+	HttpResponse response;
+	bool retry = false;
+	int retry_delay_ms = 0;
+	bool throttled = false; // The retry waits for a web_search_max_qps token - it does not count as an attempt
 };
 
 class HttpClient {
 public:
-	static HttpResponse Fetch(ClientContext &context, const std::string &url, const RetryConfig &config);
+	// Attempt `attempt` (0 = first) of fetching a URL. Never sleeps: a failed attempt that should be retried comes
+	// back with retry set and a jittered backoff, and the caller fetches other work until it is due. So does one
+	// that waits for a web_search_max_qps token (throttled set).
+	// The first attempt goes through the on-disk response cache according to web_search_cache_mode.
+	// Concurrent fetches of the same URL are coalesced into one request.
+	// stats: optional counters of the calling scan
+	static FetchAttempt TryFetch(ClientContext &context, const std::string &url, const RetryConfig &config,
+	                             int attempt, WebSearchScanStats *stats = nullptr);
+
+	// Fetch several URLs concurrently (at most max_concurrency in flight), retrying failed ones on a timer while
+	// the others are fetched. Responses are returned in URL order.
+	static vector<HttpResponse> FetchAll(ClientContext &context, const vector<std::string> &urls,
+	                                     const RetryConfig &config, idx_t max_concurrency);
 
 private:
-	static HttpResponse ExecuteHttpGet(DatabaseInstance &db, const std::string &url);
+	static HttpResponse FetchOnce(ClientContext &context, const std::string &url, bool use_cache, bool is_retry,
+	                              WebSearchScanStats *stats);
+	static int RetryDelayMs(const RetryConfig &config, int attempt, const HttpResponse &response);
+	static HttpResponse ExecuteHttpGet(ClientContext &context, const std::string &url);
+	// ExecuteHttpGet, plus a duplicate request if no response came within web_search_hedge_percentile. Whichever
+	// succeeds first is used; the other one is abandoned.
+	static HttpResponse ExecuteHedgedHttpGet(ClientContext &context, const std::string &url, WebSearchScanStats *stats);
 	static bool IsRetryable(int status_code);
 	static int ParseRetryAfter(const std::string &retry_after);
 };
 
-// URL encoding helper
+// Run task(0) .. task(task_count - 1) on up to max_concurrency threads (the caller is one of them).
+// The first exception thrown by a task is rethrown on the calling thread once all tasks finished.
+void RunConcurrently(idx_t task_count, idx_t max_concurrency, const std::function<void(idx_t)> &task);
+
+// URL encoding helpers
 std::string UrlEncode(const std::string &value);
+void AppendUrlEncoded(std::string &out, const std::string &value);
+// Append &name=value (value URL encoded)
+void AppendUrlParameter(std::string &url, const char *name, const std::string &value);
 
 } // namespace duckdb
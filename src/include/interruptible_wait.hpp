@@ -0,0 +1,51 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace duckdb {
+
+// Waits block at most this long before checking whether the query was interrupted (Ctrl-C)
+static constexpr std::chrono::milliseconds INTERRUPT_CHECK_INTERVAL(50);
+
+// Throws InterruptException once the query of the context is interrupted
+inline void CheckInterrupted(ClientContext &context) {
+	if (context.IsInterrupted()) {
+		throw InterruptException();
+	}
+}
+
+// Wait on cv until done() holds or the deadline passes, in slices that check for an interrupt.
+// Returns done() - false on the deadline. Throws InterruptException (holding the lock again) when interrupted.
+template <class DONE>
+bool WaitUntilInterruptible(ClientContext &context, std::condition_variable &cv, std::unique_lock<mutex> &guard,
+                            std::chrono::steady_clock::time_point deadline, DONE &&done) {
+	while (!done()) {
+		CheckInterrupted(context);
+		auto now = std::chrono::steady_clock::now();
+		if (now >= deadline) {
+			return false;
+		}
+		cv.wait_until(guard, MinValue(deadline, now + INTERRUPT_CHECK_INTERVAL));
+	}
+	return true;
+}
+
+// Sleep until the deadline, in slices that check for an interrupt
+inline void SleepUntilInterruptible(ClientContext &context, std::chrono::steady_clock::time_point deadline) {
+	while (true) {
+		CheckInterrupted(context);
+		auto now = std::chrono::steady_clock::now();
+		if (now >= deadline) {
+			return;
+		}
+		std::this_thread::sleep_until(MinValue(deadline, now + INTERRUPT_CHECK_INTERVAL));
+	}
+}
+
+} // namespace duckdb
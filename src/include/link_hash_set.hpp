@@ -0,0 +1,86 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Set of link hashes with open addressing (linear probing), 8 bytes per slot. Used by dedupe := true to drop
+// results whose link was already returned, and by since_table := '...' for the links seen by earlier runs.
+// Distinct links with the same 64-bit hash are treated as duplicates.
+class LinkHashSet {
+public:
+	LinkHashSet() : slots(INITIAL_CAPACITY, EMPTY) {
+	}
+
+	// Returns false if the link was seen before
+	bool Insert(const string_t &link) {
+		auto hash = LinkHash(link);
+		if ((count + 1) * 2 > slots.size()) {
+			Grow();
+		}
+		if (!InsertHash(hash)) {
+			return false;
+		}
+		count++;
+		checksum += hash;
+		return true;
+	}
+
+	bool Contains(const string_t &link) const {
+		auto hash = LinkHash(link);
+		auto mask = slots.size() - 1;
+		for (auto slot = hash & mask; slots[slot] != EMPTY; slot = (slot + 1) & mask) {
+			if (slots[slot] == hash) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	idx_t Count() const {
+		return count;
+	}
+
+	// Independent of the insertion order, so two sets with the same links have the same checksum
+	hash_t Checksum() const {
+		return checksum;
+	}
+
+private:
+	static constexpr idx_t INITIAL_CAPACITY = 256; // Power of two
+	static constexpr hash_t EMPTY = 0;
+
+	static hash_t LinkHash(const string_t &link) {
+		auto hash = Hash(link.GetData(), link.GetSize());
+		return hash == EMPTY ? 1 : hash;
+	}
+
+	bool InsertHash(hash_t hash) {
+		auto mask = slots.size() - 1;
+		for (auto slot = hash & mask;; slot = (slot + 1) & mask) {
+			if (slots[slot] == hash) {
+				return false;
+			}
+			if (slots[slot] == EMPTY) {
+				slots[slot] = hash;
+				return true;
+			}
+		}
+	}
+
+	void Grow() {
+		vector<hash_t> old_slots(slots.size() * 2, EMPTY);
+		std::swap(slots, old_slots);
+		for (auto hash : old_slots) {
+			if (hash != EMPTY) {
+				InsertHash(hash);
+			}
+		}
+	}
+
+	vector<hash_t> slots;
+	idx_t count = 0;
+	hash_t checksum = 0;
+};
+
+} // namespace duckdb
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Requests of one key/cx, see ApiRateLimiter::GetKeyUsage
+struct ApiKeyUsage {
+	string cx;
+	string key_hint; // Last characters of the API key
+	int64_t requests_today = 0;
+	int64_t requests_total = 0;     // Since the extension was loaded
+	int64_t rate_limited_total = 0; // 429 responses since the extension was loaded
+};
+
+// Outcome of ApiRateLimiter::Acquire
+enum class RateLimitResult : uint8_t {
+	ACQUIRED,
+	THROTTLED,      // No web_search_max_qps token left this second - try again after wait_ms
+	QUOTA_EXHAUSTED // The key's web_search_daily_quota is used up - fail over to another key, if there is one
+};
+
+// The rate limiter settings of a connection, read on its thread for use where the ClientContext is not available
+struct RateLimitSettings {
+	double max_qps = 0;            // web_search_max_qps
+	int64_t daily_quota = 0;       // web_search_daily_quota
+	int64_t hedge_daily_quota = 0; // web_search_hedge_daily_quota
+
+	static RateLimitSettings FromContext(ClientContext &context);
+};
+
+// Process-wide request budget per API key and search engine (cx), shared by all connections and threads:
+// a token bucket for requests per second (web_search_max_qps) and a daily request counter (web_search_daily_quota)
+class ApiRateLimiter {
+public:
+	// Take a request token for the key/cx of this request URL. Never sleeps: when throttled, wait_ms is the time
+	// until the next token, and the caller fetches other work meanwhile.
+	static RateLimitResult Acquire(ClientContext &context, const string &url, int &wait_ms);
+	// Take a token for a hedged duplicate of a request, without waiting. False if the hedge budget
+	// (web_search_hedge_daily_quota), the daily quota or the current second's tokens are used up.
+	// Takes the settings instead of the context, as it is called from the thread that sends the hedge.
+	static bool TryAcquireHedge(const RateLimitSettings &settings, const string &url);
+
+	// Several keys (secrets := [...]): key_urls are the request URL prefixes with each key and cx, see
+	// BuildSearchKeyUrl. Pick the key of the next request, weighted by its share of the daily quota left and its
+	// recent 429s.
+	static idx_t PickKey(ClientContext &context, const vector<string> &key_urls);
+	// Count a 429 response for the key of a request URL
+	static void RecordRateLimited(ClientContext &context, const string &url);
+	// Take the key of a request that failed with a 403 (quota exceeded: for the rest of the day) or a 429 after its
+	// retries (for a minute) out of the selection. True if another key of key_urls is left to retry the request with.
+	static bool FailOver(ClientContext &context, const string &url, int status_code, const vector<string> &key_urls);
+
+	// The requests sent with each key/cx so far
+	static vector<ApiKeyUsage> GetKeyUsage();
+};
+
+// Register web_search_quota(), the remaining request budget per key
+void RegisterWebSearchQuotaFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
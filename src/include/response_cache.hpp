@@ -0,0 +1,35 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// web_search_cache_mode
+enum class ResponseCacheMode : uint8_t {
+	OFF,          // Always go to the network
+	READ_THROUGH, // Serve fresh entries from the cache, fetch and store misses
+	CACHE_ONLY,   // Never go to the network - a miss is an error
+	REFRESH       // Always go to the network and overwrite the cached entry
+};
+
+struct ResponseCacheConfig {
+	ResponseCacheMode mode = ResponseCacheMode::OFF;
+	string directory;
+	int64_t ttl_seconds = 0;
+	idx_t max_size_bytes = 0;
+
+	static ResponseCacheConfig FromContext(ClientContext &context);
+};
+
+// Persistent cache of successful Custom Search API responses: one file per response in the cache
+// directory, keyed by the normalized request URL (API key removed, parameters sorted)
+class ResponseCache {
+public:
+	static string NormalizeUrl(const string &url);
+
+	// Returns true and fills body if there is an entry younger than the TTL
+	static bool TryGet(ClientContext &context, const ResponseCacheConfig &config, const string &url, string &body);
+	static void Put(ClientContext &context, const ResponseCacheConfig &config, const string &url, const string &body);
+};
+
+} // namespace duckdb
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <chrono>
+#include <list>
+#include <mutex>
+
+namespace duckdb {
+
+struct ResultCacheConfig {
+	idx_t max_size_bytes = 0; // 0 = disabled
+	int64_t ttl_seconds = 0;  // 0 = entries never expire
+	bool read = true;         // False in web_search_cache_mode = 'refresh': store, but never serve
+
+	static ResultCacheConfig FromContext(ClientContext &context);
+};
+
+// Process-wide LRU cache of complete, parsed result lists. The key describes the query after all pushdowns
+// (see ResultCacheKey), so re-running an identical google_search() skips both the requests and the JSON parsing.
+template <class RESULT>
+class ResultCache {
+public:
+	using ResultList = vector<RESULT>;
+
+	static ResultCache &Get() {
+		static ResultCache cache;
+		return cache;
+	}
+
+	shared_ptr<const ResultList> Lookup(const ResultCacheConfig &config, const string &key) {
+		if (config.max_size_bytes == 0 || !config.read) {
+			return nullptr;
+		}
+		lock_guard<mutex> guard(lock);
+		auto entry = index.find(key);
+		if (entry == index.end()) {
+			return nullptr;
+		}
+		if (config.ttl_seconds > 0 && MonotonicSeconds() - entry->second->inserted_at > config.ttl_seconds) {
+			Erase(entry->second);
+			return nullptr;
+		}
+		// Move to the front of the LRU list
+		lru.splice(lru.begin(), lru, entry->second);
+		return entry->second->results;
+	}
+
+	void Store(const ResultCacheConfig &config, const string &key, shared_ptr<const ResultList> results,
+	           idx_t size_bytes) {
+		if (config.max_size_bytes == 0 || size_bytes > config.max_size_bytes) {
+			return;
+		}
+		lock_guard<mutex> guard(lock);
+		auto existing = index.find(key);
+		if (existing != index.end()) {
+			Erase(existing->second);
+		}
+		lru.push_front(CacheEntry {key, std::move(results), size_bytes, MonotonicSeconds()});
+		index[key] = lru.begin();
+		total_size += size_bytes;
+		// The budget is whatever the storing connection has configured
+		while (total_size > config.max_size_bytes && !lru.empty()) {
+			Erase(std::prev(lru.end()));
+		}
+	}
+
+private:
+	struct CacheEntry {
+		string key;
+		shared_ptr<const ResultList> results;
+		idx_t size_bytes;
+		int64_t inserted_at;
+	};
+	using EntryIterator = typename std::list<CacheEntry>::iterator;
+
+	static int64_t MonotonicSeconds() {
+		return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch())
+		    .count();
+	}
+
+	void Erase(EntryIterator entry) {
+		total_size -= entry->size_bytes;
+		index.erase(entry->key);
+		lru.erase(entry);
+	}
+
+	mutex lock;
+	std::list<CacheEntry> lru; // Most recently used first
+	unordered_map<string, EntryIterator> index;
+	idx_t total_size = 0;
+};
+
+// Cache key of a result list: the first page request with the API key removed, plus the result count
+string ResultCacheKey(const string &first_page_url, idx_t max_results, const string &mode = string());
+
+} // namespace duckdb
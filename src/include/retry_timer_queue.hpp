@@ -0,0 +1,63 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <chrono>
+#include <queue>
+
+namespace duckdb {
+
+// Work waiting for its retry, ordered by due time. Not synchronized - guarded by the owner's lock.
+// A thread that finds nothing due picks up other work instead of sleeping through the backoff.
+template <class T>
+class RetryTimerQueue {
+public:
+	using clock = std::chrono::steady_clock;
+
+	void Push(T item, int delay_ms) {
+		entries.push(Entry {clock::now() + std::chrono::milliseconds(delay_ms), next_sequence++, std::move(item)});
+	}
+
+	// Pop the earliest item if its time has come
+	bool PopDue(T &item) {
+		if (entries.empty() || entries.top().due > clock::now()) {
+			return false;
+		}
+		item = entries.top().item;
+		entries.pop();
+		return true;
+	}
+
+	// Pop the earliest item, due or not
+	void PopFirst(T &item) {
+		item = entries.top().item;
+		entries.pop();
+	}
+
+	bool Empty() const {
+		return entries.empty();
+	}
+	idx_t Size() const {
+		return entries.size();
+	}
+	// Due time of the earliest item (the queue must not be empty)
+	clock::time_point NextDue() const {
+		return entries.top().due;
+	}
+
+private:
+	struct Entry {
+		clock::time_point due;
+		idx_t sequence; // FIFO among items due at the same time
+		T item;
+	};
+	struct Later {
+		bool operator()(const Entry &a, const Entry &b) const {
+			return a.due != b.due ? a.due > b.due : a.sequence > b.sequence;
+		}
+	};
+
+	std::priority_queue<Entry, vector<Entry>, Later> entries;
+	idx_t next_sequence = 0;
+};
+
+} // namespace duckdb
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+
+namespace duckdb {
+
+// Counters of one scan, shared by its threads and shown in EXPLAIN ANALYZE
+struct WebSearchScanStats {
+	std::atomic<idx_t> requests {0};   // HTTP requests sent, including retries
+	std::atomic<idx_t> retries {0};
+	std::atomic<idx_t> hedges {0}; // Duplicate requests sent for slow responses
+	std::atomic<idx_t> bytes {0};      // Response bytes received (decompressed)
+	std::atomic<idx_t> wire_bytes {0}; // Response bytes received as sent (gzip-compressed)
+	std::atomic<idx_t> cache_hits {0}; // Responses served by the response cache
+	std::atomic<idx_t> coalesced {0};  // Responses shared with a concurrent fetch of the same URL
+	std::atomic<idx_t> key_failovers {0}; // Pages moved to another key after a 403 or 429 (secrets := [...])
+	std::atomic<idx_t> network_us {0};
+	std::atomic<idx_t> parse_us {0};
+	std::atomic<idx_t> backoff_ms {0}; // Retry delays scheduled
+	bool result_cache_hit = false; // Served by the result cache without any request
+
+	void AddTo(InsertionOrderPreservingMap<string> &result) const;
+};
+
+// Counters of all scans and requests of the process since the extension was loaded, shown by web_search_stats().
+// Relaxed atomics only: they are read as a snapshot, never to synchronize.
+struct WebSearchProcessStats {
+	// Status codes outside 1..STATUS_SLOTS-1 share slot 0 with network errors
+	static constexpr idx_t STATUS_SLOTS = 600;
+
+	static WebSearchProcessStats &Get() {
+		static WebSearchProcessStats instance;
+		return instance;
+	}
+
+	std::atomic<idx_t> scans {0};
+	std::atomic<idx_t> requests {0}; // HTTP requests sent, including retries and hedges
+	std::atomic<idx_t> retries {0};
+	std::atomic<idx_t> hedges {0};
+	std::atomic<idx_t> coalesced {0};
+	std::atomic<idx_t> backoff_ms {0};
+	std::atomic<idx_t> bytes {0};
+	std::atomic<idx_t> wire_bytes {0};
+	std::atomic<idx_t> network_us {0};
+	std::atomic<idx_t> parse_us {0};
+	std::atomic<idx_t> response_cache_hits {0};
+	std::atomic<idx_t> response_cache_misses {0};
+	std::atomic<idx_t> result_cache_hits {0};
+	std::atomic<idx_t> result_cache_misses {0};
+	std::atomic<idx_t> key_failovers {0};
+	std::atomic<idx_t> rate_limited_scans {0}; // Scans that returned partial results on a 429
+	// By HTTP status, 0 = network error
+	std::array<std::atomic<idx_t>, STATUS_SLOTS> responses_by_status;
+	std::array<std::atomic<idx_t>, STATUS_SLOTS> retries_by_status;
+
+	static void Add(std::atomic<idx_t> &counter, idx_t value = 1) {
+		counter.fetch_add(value, std::memory_order_relaxed);
+	}
+	static void AddStatus(std::array<std::atomic<idx_t>, STATUS_SLOTS> &counters, int status_code) {
+		auto slot = status_code > 0 && idx_t(status_code) < STATUS_SLOTS ? idx_t(status_code) : 0;
+		Add(counters[slot]);
+	}
+
+private:
+	WebSearchProcessStats() {
+		for (idx_t i = 0; i < STATUS_SLOTS; i++) {
+			responses_by_status[i] = 0;
+			retries_by_status[i] = 0;
+		}
+	}
+};
+
+// Adds the time the scope took to a counter of the scan (if any) and of the process (if any)
+class ScanStatsTimer {
+public:
+	explicit ScanStatsTimer(std::atomic<idx_t> *target_p, std::atomic<idx_t> *process_target_p = nullptr)
+	    : target(target_p), process_target(process_target_p), start(std::chrono::steady_clock::now()) {
+	}
+	~ScanStatsTimer() {
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		auto micros = static_cast<idx_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+		if (target) {
+			*target += micros;
+		}
+		if (process_target) {
+			WebSearchProcessStats::Add(*process_target, micros);
+		}
+	}
+
+private:
+	std::atomic<idx_t> *target;
+	std::atomic<idx_t> *process_target;
+	std::chrono::steady_clock::time_point start;
+};
+
+// Register web_search_stats(), the process-wide counters and the quota used per key
+void RegisterWebSearchStatsFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,416 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "google_search_secret.hpp"
+#include "http_client.hpp"
+#include "rate_limiter.hpp"
+#include "result_cache.hpp"
+#include "scan_stats.hpp"
+#include "search_scheduler.hpp"
+#include "web_search_settings.hpp"
+#include "yyjson.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
+
+// Result-fetching engine shared by google_search() and google_image_search(): parsed response documents, the
+// paginated multithreaded scan with retries and the result cache. A RESULT type holds views into its document and a
+// `shared_ptr<SearchApiDocument> document` member.
+
+namespace duckdb {
+
+// Parsed API response. Results point into its string storage, so it lives as long as any of them.
+struct SearchApiDocument {
+	SearchApiDocument(duckdb_yyjson::yyjson_doc *doc, idx_t size) : doc(doc), size(size) {
+	}
+	~SearchApiDocument() {
+		duckdb_yyjson::yyjson_doc_free(doc);
+	}
+
+	duckdb_yyjson::yyjson_doc *doc;
+	idx_t size;             // Response body size
+	idx_t result_count = 0; // Results referencing this document
+};
+
+// Keeps a response document alive while a vector references its strings
+class SearchApiDocumentBuffer : public VectorBuffer {
+public:
+	explicit SearchApiDocumentBuffer(shared_ptr<SearchApiDocument> document_p)
+	    : VectorBuffer(VectorBufferType::OPAQUE_BUFFER), document(std::move(document_p)) {
+	}
+
+private:
+	shared_ptr<SearchApiDocument> document;
+};
+
+// Parse a response body, throws if it is not JSON or an API error object
+shared_ptr<SearchApiDocument> ReadSearchApiResponse(const string &response_body);
+// The items array of a response, nullptr if there are no results
+duckdb_yyjson::yyjson_val *GetSearchApiItems(const SearchApiDocument &document);
+// The startIndex of the next page, or -1 if no more pages
+int GetSearchApiNextStart(const SearchApiDocument &document);
+
+// Check an API response before parsing it.
+// Returns false if the scan should stop and return the results gathered so far (rate limited)
+bool CheckSearchApiResponse(const HttpResponse &response, idx_t results_so_far);
+
+// The status to hand a request over to another key on (see ApiRateLimiter::FailOver), or 0: a 403 with a quota
+// reason (dailyLimitExceeded, quotaExceeded) or a 429 that is still rate limited after its retries
+int GetKeyFailoverStatus(const HttpResponse &response);
+
+// HttpClient::FetchAll of key_url + suffix for each suffix, with a key picked per request (ApiRateLimiter::PickKey).
+// With several keys, a request that needs to fail over (GetKeyFailoverStatus) is sent again with another key.
+vector<HttpResponse> FetchAllAcrossKeys(ClientContext &context, const vector<string> &key_urls,
+                                        const vector<string> &url_suffixes, const RetryConfig &config);
+
+// JSON helpers - strings are views into the document, missing values are "" and 0
+string_t GetJsonString(duckdb_yyjson::yyjson_val *obj, const char *key);
+int GetJsonInt(duckdb_yyjson::yyjson_val *obj, const char *key);
+
+// Request URL prefix of a secret: its endpoint (else web_search_endpoint) with its key and cx
+string BuildSearchKeyUrl(const string &endpoint, const GoogleSearchConfig &config);
+vector<string> BuildSearchKeyUrls(ClientContext &context, const vector<GoogleSearchConfig> &configs);
+
+// A column that has the same value for every row: the pushed down filter value, or NULL
+void SetSearchFilterColumn(Vector &column, const string &value);
+
+// Match ORDER BY date (or ORDER BY date LIMIT n) directly above a scan of function_name, skipping projections.
+// Returns the scan and sets sort_param to the API sort parameter, or nullptr if the order cannot be pushed down.
+optional_ptr<LogicalGet> MatchSearchOrderByDate(LogicalOperator &op, const string &function_name, string &sort_param);
+
+// Make the vector keep alive the documents its strings point into (once per run of rows from the same response)
+template <class RESULT>
+void AttachSearchApiDocuments(Vector &column, const vector<RESULT> &results, idx_t start, idx_t count) {
+	SearchApiDocument *attached = nullptr;
+	for (idx_t row = 0; row < count; row++) {
+		auto &document = results[start + row].document;
+		if (document && document.get() != attached) {
+			StringVector::AddBuffer(column, make_buffer<SearchApiDocumentBuffer>(document));
+			attached = document.get();
+		}
+	}
+}
+
+// Approximate memory footprint of a result, for the result cache budget
+template <class RESULT>
+idx_t EstimateSearchResultSize(const RESULT &result) {
+	// Strings live in the response document - count this result's share of it
+	auto &document = result.document;
+	return sizeof(RESULT) + (document ? document->size / MaxValue<idx_t>(document->result_count, 1) : 0);
+}
+
+// Global state of a paginated search scan
+template <class RESULT>
+struct SearchScanGlobalState : public GlobalTableFunctionState {
+	SearchScanGlobalState(idx_t stream_count, idx_t max_results, idx_t window)
+	    : scheduler(stream_count, max_results, window) {
+	}
+
+	// Take one of the max_concurrency request slots
+	bool AcquireFetchSlot() {
+		if (fetching.fetch_add(1) < max_concurrency) {
+			return true;
+		}
+		fetching--;
+		return false;
+	}
+
+	SearchPageScheduler scheduler;
+	idx_t max_threads = 1;
+	// Requests in flight across the scan's threads, at most max_concurrency (web_search_max_concurrency)
+	idx_t max_concurrency = 1;
+	std::atomic<idx_t> fetching {0};
+	// Report pages to the scheduler when they are emitted rather than fetched, after the filter of
+	// SearchScanNextRows. Only with max_threads = 1, so pages are emitted in ordinal order.
+	bool complete_on_emit = false;
+	RetryConfig retry_config;
+	WebSearchScanStats stats;
+
+	// Projected columns and the matching field mask
+	vector<column_t> column_ids;
+	string fields;
+	// Request URL prefix of each secret (see BuildSearchKeyUrl), and the parameters of each stream without the key and
+	// start, built once per scan
+	vector<string> key_urls;
+	vector<string> stream_urls;
+
+	// Result cache: a hit is replayed as a single page, a miss collects the pages to store once the scan is done
+	string cache_key;
+	ResultCacheConfig cache_config;
+	shared_ptr<const vector<RESULT>> cached_results;
+	bool collect_for_cache = false;
+	mutex cache_lock;
+	std::map<idx_t, vector<RESULT>> cache_pages; // By page ordinal
+	bool cache_stored = false;
+
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
+};
+
+// Per-thread state: the pages this thread fetched and is emitting
+template <class RESULT>
+struct SearchScanLocalState : public LocalTableFunctionState {
+	SearchPageQueue<RESULT> queue;
+	vector<RESULT> results;
+	idx_t current_idx = 0;
+	idx_t batch_index = 0;
+};
+
+// Create the global state of a scan. A repeated query is served from the result cache as a single page, otherwise
+// pages are claimed by the scan threads on demand, so an early stop upstream does not spend more quota.
+template <class STATE, class RESULT>
+unique_ptr<STATE> InitSearchScanState(ClientContext &context, const vector<column_t> &column_ids, string fields,
+                                      string cache_key, idx_t stream_count, idx_t max_results, idx_t window) {
+	auto cache_config = ResultCacheConfig::FromContext(context);
+	auto cached = ResultCache<RESULT>::Get().Lookup(cache_config, cache_key);
+	auto &process_stats = WebSearchProcessStats::Get();
+	WebSearchProcessStats::Add(process_stats.scans);
+	if (cache_config.max_size_bytes > 0) {
+		WebSearchProcessStats::Add(cached ? process_stats.result_cache_hits : process_stats.result_cache_misses);
+	}
+
+	unique_ptr<STATE> state;
+	if (cached) {
+		state = make_uniq<STATE>(1, 1, 1);
+		state->cached_results = std::move(cached);
+		state->stats.result_cache_hit = true;
+	} else {
+		state = make_uniq<STATE>(stream_count, max_results, window);
+		idx_t max_pages = state->scheduler.MaxPages();
+		state->max_concurrency = GetMaxConcurrency(context);
+		state->max_threads =
+		    MinValue<idx_t>(window > 0 ? MinValue<idx_t>(window, max_pages) : max_pages, state->max_concurrency);
+		state->collect_for_cache = cache_config.max_size_bytes > 0;
+	}
+	state->retry_config = RetryConfig::FromContext(context);
+	state->column_ids = column_ids;
+	state->fields = std::move(fields);
+	state->cache_key = std::move(cache_key);
+	state->cache_config = cache_config;
+	return state;
+}
+
+// Request URL of a page: a key picked by ApiRateLimiter::PickKey, its stream's parameters and start offset
+template <class RESULT>
+string BuildSearchPageUrl(ClientContext &context, const SearchScanGlobalState<RESULT> &state,
+                          const SearchPageUnit &unit) {
+	auto &key_url = state.key_urls[ApiRateLimiter::PickKey(context, state.key_urls)];
+	auto &stream_url = state.stream_urls[unit.stream];
+	string url;
+	url.reserve(key_url.size() + stream_url.size() + 16);
+	url += key_url;
+	url += stream_url;
+	url += "&start=";
+	url += std::to_string(unit.Start());
+	return url;
+}
+
+// Put the complete result list into the result cache once the last page is in
+template <class RESULT>
+void StoreSearchScanResults(SearchScanGlobalState<RESULT> &state) {
+	lock_guard<mutex> guard(state.cache_lock);
+	if (state.cache_stored || !state.scheduler.Finished()) {
+		return;
+	}
+	state.cache_stored = true;
+	if (state.scheduler.Stopped()) {
+		return; // Rate limited - incomplete
+	}
+
+	auto results = make_shared_ptr<vector<RESULT>>();
+	idx_t size = 0;
+	for (auto &page : state.cache_pages) {
+		for (auto &result : page.second) {
+			size += EstimateSearchResultSize(result);
+			results->push_back(std::move(result));
+		}
+	}
+	state.cache_pages.clear();
+	ResultCache<RESULT>::Get().Store(state.cache_config, state.cache_key, std::move(results), size);
+}
+
+// Handle the outcome of fetching a claimed page: parse it into the thread's queue, or defer it there for a retry
+// parse(body, results): appends the page's results, returns the next startIndex or -1 if no more pages
+template <class RESULT, class PARSE>
+void HandleSearchScanPage(ClientContext &context, SearchScanGlobalState<RESULT> &state, SearchPageUnit unit,
+                          const string &url, FetchAttempt &attempt, SearchPageQueue<RESULT> &queue, PARSE &&parse) {
+	if (attempt.retry) {
+		if (!attempt.throttled) {
+			unit.attempt++;
+		}
+		queue.Defer(unit, attempt.retry_delay_ms);
+		return;
+	}
+	auto &response = attempt.response;
+
+	// With several keys, one that is out of quota or still rate limited after its retries hands the page over
+	auto failover_status = GetKeyFailoverStatus(response);
+	if (failover_status != 0 && ApiRateLimiter::FailOver(context, url, failover_status, state.key_urls)) {
+		state.stats.key_failovers++;
+		WebSearchProcessStats::Add(WebSearchProcessStats::Get().key_failovers);
+		unit.attempt = 0;
+		queue.Defer(unit, 0);
+		return;
+	}
+
+	// Stops with partial results on 429, throws otherwise
+	if (!CheckSearchApiResponse(response, state.scheduler.ResultCount())) {
+		state.scheduler.Stop();
+		state.scheduler.Complete(unit, 0, true);
+		return;
+	}
+
+	// Pages are not cut to the LIMIT - the LIMIT operator above the scan does that in page order
+	vector<RESULT> results;
+	int next_start;
+	{
+		ScanStatsTimer timer(&state.stats.parse_us, &WebSearchProcessStats::Get().parse_us);
+		next_start = parse(response.body, results);
+	}
+	bool last_page = next_start < 0 || unit.page + 1 >= SEARCH_MAX_PAGES; // Google max 100 per query
+	if (!state.complete_on_emit) {
+		if (state.collect_for_cache) {
+			lock_guard<mutex> guard(state.cache_lock);
+			state.cache_pages[unit.ordinal] = results;
+		}
+		state.scheduler.Complete(unit, results.size(), last_page);
+	}
+	queue.AddReady(unit, std::move(results), last_page);
+}
+
+// Fetch the claimed pages concurrently (each holds a request slot, released here), then handle them in order
+// build_url(unit): the request URL of the page. See HandleSearchScanPage for parse.
+template <class RESULT, class BUILD_URL, class PARSE>
+void FetchSearchScanPages(ClientContext &context, SearchScanGlobalState<RESULT> &state,
+                          const vector<SearchPageUnit> &units, SearchPageQueue<RESULT> &queue, BUILD_URL &&build_url,
+                          PARSE &&parse) {
+	if (state.cached_results) {
+		state.fetching -= units.size();
+		for (auto &unit : units) {
+			state.scheduler.Complete(unit, state.cached_results->size(), true);
+			queue.AddReady(unit, *state.cached_results, true);
+		}
+		return;
+	}
+
+	vector<string> urls;
+	for (auto &unit : units) {
+		urls.push_back(build_url(unit));
+	}
+	vector<FetchAttempt> attempts(units.size());
+	try {
+		RunConcurrently(units.size(), units.size(), [&](idx_t i) {
+			attempts[i] = HttpClient::TryFetch(context, urls[i], state.retry_config, units[i].attempt, &state.stats);
+		});
+	} catch (...) {
+		state.fetching -= units.size();
+		throw;
+	}
+	state.fetching -= units.size();
+	for (idx_t i = 0; i < units.size(); i++) {
+		HandleSearchScanPage(context, state, units[i], urls[i], attempts[i], queue, parse);
+	}
+}
+
+// Emit the next page of the thread. With complete_on_emit, filter(results) runs first, then the page is reported
+// to the scheduler with the rows that are left.
+template <class RESULT, class FILTER>
+void EmitSearchScanPage(SearchScanGlobalState<RESULT> &state, SearchScanLocalState<RESULT> &local,
+                        SearchReadyPage<RESULT> &page, FILTER &&filter) {
+	if (state.complete_on_emit && !state.cached_results) {
+		filter(page.results);
+		if (state.collect_for_cache) {
+			lock_guard<mutex> guard(state.cache_lock);
+			state.cache_pages[page.unit.ordinal] = page.results;
+		}
+		state.scheduler.Complete(page.unit, page.results.size(), page.last_page);
+		if (state.collect_for_cache) {
+			StoreSearchScanResults(state);
+		}
+	}
+	local.batch_index = page.unit.ordinal;
+	local.results = std::move(page.results);
+	local.current_idx = 0;
+}
+
+// Claim and fetch pages until this thread has rows to emit at local.current_idx
+// Returns false once the scan is exhausted for this thread. See FetchSearchScanPages for build_url and parse, and
+// EmitSearchScanPage for filter.
+template <class RESULT, class BUILD_URL, class PARSE, class FILTER>
+bool SearchScanNextRows(ClientContext &context, SearchScanGlobalState<RESULT> &state,
+                        SearchScanLocalState<RESULT> &local, BUILD_URL &&build_url, PARSE &&parse, FILTER &&filter) {
+	while (local.current_idx >= local.results.size()) {
+		if (state.scheduler.Stopped()) {
+			local.queue.DropRetries(state.scheduler);
+		}
+		SearchReadyPage<RESULT> page;
+		if (local.queue.NextReady(page)) {
+			EmitSearchScanPage(state, local, page, filter);
+			continue;
+		}
+		// Due retries first, then new pages: all that can be claimed go out together, so a single thread keeps the
+		// whole window in flight. Waits for a retry only if there is nothing else to fetch.
+		vector<SearchPageUnit> units;
+		SearchPageUnit unit;
+		bool slots_full = false;
+		while (true) {
+			if (!state.AcquireFetchSlot()) {
+				slots_full = true;
+				break;
+			}
+			if (!local.queue.PopDueRetry(unit) && !state.scheduler.Claim(unit)) {
+				state.fetching--;
+				break;
+			}
+			units.push_back(unit);
+		}
+		if (!units.empty()) {
+			FetchSearchScanPages(context, state, units, local.queue, build_url, parse);
+		} else if (!local.queue.WaitForRetry(context, slots_full)) {
+			return false;
+		}
+		if (state.collect_for_cache) {
+			StoreSearchScanResults(state);
+		}
+	}
+	return true;
+}
+
+template <class RESULT, class BUILD_URL, class PARSE>
+bool SearchScanNextRows(ClientContext &context, SearchScanGlobalState<RESULT> &state,
+                        SearchScanLocalState<RESULT> &local, BUILD_URL &&build_url, PARSE &&parse) {
+	return SearchScanNextRows(context, state, local, build_url, parse, [](vector<RESULT> &) {});
+}
+
+template <class RESULT>
+unique_ptr<LocalTableFunctionState> SearchScanInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                        GlobalTableFunctionState *global_state) {
+	return make_uniq<SearchScanLocalState<RESULT>>();
+}
+
+// Pages are emitted with their ordinal as batch index, so insertion order is preserved across threads
+template <class RESULT>
+OperatorPartitionData SearchScanGetPartitionData(ClientContext &context, TableFunctionGetPartitionInput &input) {
+	auto &local = input.local_state->Cast<SearchScanLocalState<RESULT>>();
+	return OperatorPartitionData(local.batch_index);
+}
+
+template <class RESULT>
+double SearchScanProgress(ClientContext &context, const FunctionData *bind_data,
+                          const GlobalTableFunctionState *global_state) {
+	return global_state->Cast<SearchScanGlobalState<RESULT>>().scheduler.Progress();
+}
+
+// EXPLAIN ANALYZE: requests, bytes and time spent by the scan
+template <class RESULT>
+InsertionOrderPreservingMap<string> SearchScanDynamicToString(TableFunctionDynamicToStringInput &input) {
+	InsertionOrderPreservingMap<string> result;
+	if (input.global_state) {
+		input.global_state->Cast<SearchScanGlobalState<RESULT>>().stats.AddTo(result);
+	}
+	return result;
+}
+
+} // namespace duckdb
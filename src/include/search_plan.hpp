@@ -0,0 +1,36 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Google caps the q parameter; longer queries are rejected with a 400
+static constexpr idx_t SEARCH_MAX_QUERY_LENGTH = 2048;
+
+// How the included sites of a search are split into API queries. Every group is one query (one result stream of
+// up to 100 results): its sites are OR'd into q, or passed as siteSearch when a group has a single site.
+struct SearchSitePlan {
+	vector<vector<string>> groups; // Empty: no site filter, a single query
+	idx_t estimated_results = 0;   // Results the plan can return (up to the LIMIT)
+	idx_t estimated_requests = 0;  // Page requests to get them
+
+	idx_t QueryCount() const {
+		return MaxValue<idx_t>(groups.size(), 1);
+	}
+	// A multi-query plan searches a lone site with siteSearch instead of adding it to q
+	bool UseSiteSearch(idx_t group) const {
+		return groups.size() > 1 && groups[group].size() == 1;
+	}
+	// e.g. "3 queries: (a OR b), (c OR d), e"
+	string ToString() const;
+};
+
+// Pick the cheapest grouping of sites for max_results: enough queries to reach max_results (100 per query), few
+// enough that no query is spent on sites that may return nothing, and no q longer than SEARCH_MAX_QUERY_LENGTH.
+// base_query_length: length of q without the site clause
+SearchSitePlan PlanSearchSites(const vector<string> &sites, idx_t max_results, idx_t base_query_length);
+
+// The " (site:a OR site:b)" clause added to q for a group
+string SearchSiteClause(const vector<string> &sites);
+
+} // namespace duckdb
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "interruptible_wait.hpp"
+#include "retry_timer_queue.hpp"
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace duckdb {
+
+// Google returns at most 10 results per request and 100 per query (start + num <= 101)
+static constexpr idx_t SEARCH_RESULTS_PER_PAGE = 10;
+static constexpr idx_t SEARCH_MAX_PAGES = 10;
+// How often a scan thread with a due retry checks for a free request slot
+static constexpr std::chrono::milliseconds FETCH_SLOT_POLL_INTERVAL {5};
+
+// One page request: page `page` of result stream `stream` (a stream is one API query, e.g. one site)
+struct SearchPageUnit {
+	idx_t ordinal = 0; // Position in output order, used as the batch index
+	idx_t stream = 0;
+	idx_t page = 0;
+	int attempt = 0; // Retries so far
+
+	int Start() const {
+		return static_cast<int>(1 + page * SEARCH_RESULTS_PER_PAGE);
+	}
+};
+
+// Hands out page requests to the threads of a parallel scan. Pages are ordered round-robin across streams
+// (page 0 of every stream, then page 1, ...), and every thread emits the pages it claimed with their ordinal as the
+// batch index, so the merged output has the same order as a sequential scan.
+class SearchPageScheduler {
+public:
+	// window: maximum pages in flight (0 = no limit besides max_results)
+	SearchPageScheduler(idx_t stream_count, idx_t max_results, idx_t window);
+
+	// Claim the next page to fetch. Returns false if nothing can be claimed right now - any further work is then
+	// claimed by a thread that still has a page in flight, once it completes.
+	bool Claim(SearchPageUnit &unit);
+	// Report a claimed page as fetched. last_page: the stream has no further pages
+	void Complete(const SearchPageUnit &unit, idx_t result_count, bool last_page);
+	// Stop handing out pages (rate limited); pages in flight still complete
+	void Stop();
+
+	// Nothing in flight and nothing left to claim
+	bool Finished();
+	bool Stopped();
+	idx_t ResultCount();
+	// Upper bound on the number of pages this scan requests
+	idx_t MaxPages() const;
+	// Pages completed out of MaxPages, in percent (for the progress bar)
+	double Progress() const;
+
+private:
+	bool CanClaim() const;
+	bool IsFinished() const;
+
+	mutable mutex lock;
+	idx_t stream_count;
+	idx_t max_results;
+	idx_t window;
+	idx_t next_ordinal = 0;
+	idx_t in_flight = 0;
+	idx_t completed_pages = 0;
+	idx_t result_count = 0;
+	bool stopped = false;
+	vector<bool> stream_exhausted;
+};
+
+// Pages of one scan thread that are fetched but not emitted yet, and its pages waiting for a retry. While a retry
+// waits for its backoff the thread fetches further pages, but it emits its pages in ordinal order: the batch
+// indexes of a thread must not decrease.
+template <class RESULT>
+struct SearchReadyPage {
+	SearchPageUnit unit;
+	vector<RESULT> results;
+	bool last_page = false; // The stream has no further pages
+};
+
+template <class RESULT>
+class SearchPageQueue {
+public:
+	void AddReady(const SearchPageUnit &unit, vector<RESULT> results, bool last_page) {
+		auto &page = ready[unit.ordinal];
+		page.unit = unit;
+		page.results = std::move(results);
+		page.last_page = last_page;
+	}
+	// Retry the page after delay_ms; it stays in flight in the scheduler until then
+	void Defer(const SearchPageUnit &unit, int delay_ms) {
+		retries.Push(unit, delay_ms);
+		retry_ordinals.insert(unit.ordinal);
+	}
+
+	// Next page to emit, unless a page before it still waits for its retry
+	bool NextReady(SearchReadyPage<RESULT> &page) {
+		if (ready.empty()) {
+			return false;
+		}
+		auto first = ready.begin();
+		if (!retry_ordinals.empty() && *retry_ordinals.begin() < first->first) {
+			return false;
+		}
+		page = std::move(first->second);
+		ready.erase(first);
+		return true;
+	}
+
+	bool PopDueRetry(SearchPageUnit &unit) {
+		if (!retries.PopDue(unit)) {
+			return false;
+		}
+		retry_ordinals.erase(retry_ordinals.find(unit.ordinal));
+		return true;
+	}
+
+	// Sleep until the earliest retry is due - only called when there is nothing else to fetch. slots_full: the
+	// retry may be due already but all request slots are taken, so sleep for at least FETCH_SLOT_POLL_INTERVAL.
+	// Returns false if no retry is pending. Throws InterruptException if the query is interrupted meanwhile.
+	bool WaitForRetry(ClientContext &context, bool slots_full) {
+		if (retries.Empty()) {
+			return false;
+		}
+		auto due = retries.NextDue();
+		if (slots_full) {
+			due = MaxValue(due, std::chrono::steady_clock::now() + FETCH_SLOT_POLL_INTERVAL);
+		}
+		SleepUntilInterruptible(context, due);
+		return true;
+	}
+
+	// Rate limited: give up the pending retries
+	void DropRetries(SearchPageScheduler &scheduler) {
+		while (!retries.Empty()) {
+			SearchPageUnit unit;
+			retries.PopFirst(unit);
+			scheduler.Complete(unit, 0, true);
+		}
+		retry_ordinals.clear();
+	}
+
+private:
+	std::map<idx_t, SearchReadyPage<RESULT>> ready;
+	RetryTimerQueue<SearchPageUnit> retries;
+	std::multiset<idx_t> retry_ordinals;
+};
+
+// Number of pages a scan keeps in flight: the prefetch_pages parameter, or sized by a pushed down LIMIT
+idx_t GetSearchPageWindow(idx_t prefetch_pages, bool limit_pushed);
+
+} // namespace duckdb
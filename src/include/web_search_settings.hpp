@@ -0,0 +1,18 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Register the web_search_* extension settings
+void RegisterWebSearchSettings(ExtensionLoader &loader);
+
+// Maximum number of API requests a single scan keeps in flight (web_search_max_concurrency)
+idx_t GetMaxConcurrency(ClientContext &context);
+
+// Custom Search API endpoint requests are sent to (web_search_endpoint)
+string GetSearchEndpoint(ClientContext &context);
+// Throws if an endpoint is not an http(s) URL without query parameters, name is the setting or secret field
+void ValidateSearchEndpoint(const string &endpoint, const char *name);
+
+} // namespace duckdb
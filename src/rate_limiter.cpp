@@ -0,0 +1,345 @@
+#include "rate_limiter.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <random>
+
+namespace duckdb {
+
+static constexpr int64_t SECONDS_PER_DAY = 24 * 60 * 60;
+// Half-life of the 429 count that weights key selection, and how long a key is skipped after failing over on a 429
+static constexpr double RATE_LIMIT_HALF_LIFE_S = 60;
+static constexpr int64_t RATE_LIMIT_COOLDOWN_S = 60;
+
+struct RateLimitBucket {
+	string cx;
+	string key_hint; // Last characters of the API key, never the full key
+
+	// Token bucket, burst size = one second worth of requests
+	double tokens = 0;
+	std::chrono::steady_clock::time_point last_refill;
+	bool initialized = false;
+
+	// Daily quota (UTC days)
+	int64_t day = 0;
+	int64_t requests_today = 0;
+	int64_t hedged_today = 0; // Hedged duplicates, also counted in requests_today
+	int64_t daily_quota = 0;  // Last configured quota, for web_search_quota()
+	// Since the extension was loaded, for web_search_stats()
+	int64_t requests_total = 0;
+	int64_t rate_limited_total = 0;
+
+	// Key selection (secrets := [...])
+	double recent_rate_limits = 0; // 429 responses, decayed by RATE_LIMIT_HALF_LIFE_S
+	std::chrono::steady_clock::time_point rate_limits_updated;
+	std::chrono::steady_clock::time_point unavailable_until; // Failed over on a 429
+	int64_t exhausted_day = -1;                              // Failed over on a 403 - out of quota for the day
+};
+
+static mutex limiter_lock;
+static std::map<string, RateLimitBucket> buckets;
+
+static string GetUrlParameter(const string &url, const string &name) {
+	auto query_start = url.find('?');
+	if (query_start == string::npos) {
+		return string();
+	}
+	for (auto &param : StringUtil::Split(url.substr(query_start + 1), '&')) {
+		if (StringUtil::StartsWith(param, name + "=")) {
+			return param.substr(name.size() + 1);
+		}
+	}
+	return string();
+}
+
+static double GetMaxQps(ClientContext &context) {
+	Value value;
+	if (context.TryGetCurrentSetting("web_search_max_qps", value) && !value.IsNull()) {
+		return value.GetValue<double>();
+	}
+	return 0;
+}
+
+static int64_t GetDailyQuota(ClientContext &context) {
+	Value value;
+	if (context.TryGetCurrentSetting("web_search_daily_quota", value) && !value.IsNull()) {
+		return value.GetValue<int64_t>();
+	}
+	return 0;
+}
+
+static int64_t GetHedgeDailyQuota(ClientContext &context) {
+	Value value;
+	if (context.TryGetCurrentSetting("web_search_hedge_daily_quota", value) && !value.IsNull()) {
+		return value.GetValue<int64_t>();
+	}
+	return 0;
+}
+
+static int64_t CurrentUtcDay() {
+	auto now = std::chrono::system_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::seconds>(now).count() / SECONDS_PER_DAY;
+}
+
+// The bucket of the key/cx of a request URL, refilled and rolled over to the current day. Caller holds limiter_lock.
+static RateLimitBucket &GetBucket(const string &url, double max_qps, int64_t daily_quota) {
+	auto key = GetUrlParameter(url, "key");
+	auto cx = GetUrlParameter(url, "cx");
+	auto &bucket = buckets[key + "&" + cx];
+	auto now = std::chrono::steady_clock::now();
+	if (!bucket.initialized) {
+		bucket.cx = StringUtil::URLDecode(cx);
+		bucket.key_hint = key.size() > 4 ? "..." + key.substr(key.size() - 4) : string();
+		bucket.tokens = MaxValue<double>(max_qps, 1);
+		bucket.last_refill = now;
+		bucket.initialized = true;
+	}
+	if (max_qps > 0) {
+		std::chrono::duration<double> elapsed = now - bucket.last_refill;
+		bucket.tokens = MinValue<double>(bucket.tokens + elapsed.count() * max_qps, MaxValue<double>(max_qps, 1));
+	}
+	bucket.last_refill = now;
+
+	auto today = CurrentUtcDay();
+	if (bucket.day != today) {
+		bucket.day = today;
+		bucket.requests_today = 0;
+		bucket.hedged_today = 0;
+	}
+	bucket.daily_quota = daily_quota;
+	return bucket;
+}
+
+RateLimitResult ApiRateLimiter::Acquire(ClientContext &context, const string &url, int &wait_ms) {
+	auto max_qps = GetMaxQps(context);
+	auto daily_quota = GetDailyQuota(context);
+
+	lock_guard<mutex> guard(limiter_lock);
+	auto &bucket = GetBucket(url, max_qps, daily_quota);
+	// Another thread may have used up the key's quota since it was picked
+	if (daily_quota > 0 && bucket.requests_today >= daily_quota) {
+		return RateLimitResult::QUOTA_EXHAUSTED;
+	}
+	if (max_qps > 0) {
+		if (bucket.tokens < 1) {
+			// Nothing is reserved: the request competes for the next token again once it is due
+			wait_ms = MaxValue<int>(static_cast<int>(std::ceil((1 - bucket.tokens) / max_qps * 1000)), 1);
+			return RateLimitResult::THROTTLED;
+		}
+		bucket.tokens -= 1;
+	}
+	bucket.requests_today++;
+	bucket.requests_total++;
+	return RateLimitResult::ACQUIRED;
+}
+
+// The 429 count of a bucket decayed to now. Caller holds limiter_lock.
+static double DecayRateLimits(RateLimitBucket &bucket, std::chrono::steady_clock::time_point now) {
+	std::chrono::duration<double> elapsed = now - bucket.rate_limits_updated;
+	bucket.recent_rate_limits *= std::pow(0.5, elapsed.count() / RATE_LIMIT_HALF_LIFE_S);
+	bucket.rate_limits_updated = now;
+	return bucket.recent_rate_limits;
+}
+
+// Whether a key can take requests. Caller holds limiter_lock.
+static bool IsKeyAvailable(const RateLimitBucket &bucket, std::chrono::steady_clock::time_point now) {
+	if (bucket.exhausted_day == bucket.day || now < bucket.unavailable_until) {
+		return false;
+	}
+	return bucket.daily_quota <= 0 || bucket.requests_today < bucket.daily_quota;
+}
+
+idx_t ApiRateLimiter::PickKey(ClientContext &context, const vector<string> &key_urls) {
+	if (key_urls.size() <= 1) {
+		return 0;
+	}
+	auto max_qps = GetMaxQps(context);
+	auto daily_quota = GetDailyQuota(context);
+	auto now = std::chrono::steady_clock::now();
+
+	// Weight: share of the daily quota left, divided by the recent 429s
+	vector<double> weights;
+	double total_weight = 0;
+	{
+		lock_guard<mutex> guard(limiter_lock);
+		for (auto &url : key_urls) {
+			auto &bucket = GetBucket(url, max_qps, daily_quota);
+			double weight = 0;
+			if (IsKeyAvailable(bucket, now)) {
+				double remaining =
+				    daily_quota > 0 ? static_cast<double>(daily_quota - bucket.requests_today) / daily_quota : 1.0;
+				weight = remaining / (1 + DecayRateLimits(bucket, now));
+			}
+			weights.push_back(weight);
+			total_weight += weight;
+		}
+	}
+	if (total_weight <= 0) {
+		return 0; // None left - the first key's error is reported
+	}
+
+	static thread_local std::mt19937 engine(std::random_device {}());
+	std::uniform_real_distribution<double> pick(0, total_weight);
+	auto point = pick(engine);
+	for (idx_t i = 0; i < weights.size(); i++) {
+		if (point < weights[i]) {
+			return i;
+		}
+		point -= weights[i];
+	}
+	return weights.size() - 1;
+}
+
+void ApiRateLimiter::RecordRateLimited(ClientContext &context, const string &url) {
+	auto now = std::chrono::steady_clock::now();
+	lock_guard<mutex> guard(limiter_lock);
+	auto &bucket = GetBucket(url, GetMaxQps(context), GetDailyQuota(context));
+	bucket.recent_rate_limits = DecayRateLimits(bucket, now) + 1;
+	bucket.rate_limited_total++;
+}
+
+bool ApiRateLimiter::FailOver(ClientContext &context, const string &url, int status_code,
+                              const vector<string> &key_urls) {
+	if (key_urls.size() <= 1) {
+		return false;
+	}
+	auto max_qps = GetMaxQps(context);
+	auto daily_quota = GetDailyQuota(context);
+	auto now = std::chrono::steady_clock::now();
+
+	lock_guard<mutex> guard(limiter_lock);
+	auto &bucket = GetBucket(url, max_qps, daily_quota);
+	if (status_code == 403) {
+		bucket.exhausted_day = bucket.day;
+	} else {
+		bucket.unavailable_until = now + std::chrono::seconds(RATE_LIMIT_COOLDOWN_S);
+	}
+	for (auto &key_url : key_urls) {
+		if (IsKeyAvailable(GetBucket(key_url, max_qps, daily_quota), now)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+RateLimitSettings RateLimitSettings::FromContext(ClientContext &context) {
+	RateLimitSettings settings;
+	settings.max_qps = GetMaxQps(context);
+	settings.daily_quota = GetDailyQuota(context);
+	settings.hedge_daily_quota = GetHedgeDailyQuota(context);
+	return settings;
+}
+
+bool ApiRateLimiter::TryAcquireHedge(const RateLimitSettings &settings, const string &url) {
+	auto max_qps = settings.max_qps;
+	auto daily_quota = settings.daily_quota;
+	auto hedge_quota = settings.hedge_daily_quota;
+
+	lock_guard<mutex> guard(limiter_lock);
+	auto &bucket = GetBucket(url, max_qps, daily_quota);
+	if (hedge_quota <= 0 || bucket.hedged_today >= hedge_quota) {
+		return false;
+	}
+	if (daily_quota > 0 && bucket.requests_today >= daily_quota) {
+		return false;
+	}
+	// A hedge is only worth it if it can be sent right away
+	if (max_qps > 0) {
+		if (bucket.tokens < 1) {
+			return false;
+		}
+		bucket.tokens -= 1;
+	}
+	bucket.requests_today++;
+	bucket.requests_total++;
+	bucket.hedged_today++;
+	return true;
+}
+
+vector<ApiKeyUsage> ApiRateLimiter::GetKeyUsage() {
+	vector<ApiKeyUsage> usage;
+	auto today = CurrentUtcDay();
+	lock_guard<mutex> guard(limiter_lock);
+	for (auto &entry : buckets) {
+		auto &bucket = entry.second;
+		ApiKeyUsage key_usage;
+		key_usage.cx = bucket.cx;
+		key_usage.key_hint = bucket.key_hint;
+		key_usage.requests_today = bucket.day == today ? bucket.requests_today : 0;
+		key_usage.requests_total = bucket.requests_total;
+		key_usage.rate_limited_total = bucket.rate_limited_total;
+		usage.push_back(std::move(key_usage));
+	}
+	return usage;
+}
+
+struct WebSearchQuotaBindData : public TableFunctionData {
+	vector<RateLimitBucket> buckets;
+};
+
+struct WebSearchQuotaGlobalState : public GlobalTableFunctionState {
+	idx_t current_idx = 0;
+};
+
+static unique_ptr<FunctionData> WebSearchQuotaBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"cx", "key", "requests_today", "daily_quota", "remaining_today", "hedged_today"};
+	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BIGINT,
+	                LogicalType::BIGINT,  LogicalType::BIGINT,  LogicalType::BIGINT};
+
+	auto bind_data = make_uniq<WebSearchQuotaBindData>();
+	auto today = CurrentUtcDay();
+	auto daily_quota = GetDailyQuota(context);
+	lock_guard<mutex> guard(limiter_lock);
+	for (auto &entry : buckets) {
+		auto bucket = entry.second;
+		if (bucket.day != today) {
+			bucket.requests_today = 0;
+			bucket.hedged_today = 0;
+		}
+		bucket.daily_quota = daily_quota;
+		bind_data->buckets.push_back(std::move(bucket));
+	}
+	return std::move(bind_data);
+}
+
+static unique_ptr<GlobalTableFunctionState> WebSearchQuotaInitGlobal(ClientContext &context,
+                                                                     TableFunctionInitInput &input) {
+	return make_uniq<WebSearchQuotaGlobalState>();
+}
+
+static void WebSearchQuotaScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<WebSearchQuotaBindData>();
+	auto &state = data.global_state->Cast<WebSearchQuotaGlobalState>();
+
+	idx_t count = 0;
+	while (count < STANDARD_VECTOR_SIZE && state.current_idx < bind_data.buckets.size()) {
+		auto &bucket = bind_data.buckets[state.current_idx];
+		output.SetValue(0, count, Value(bucket.cx));
+		output.SetValue(1, count, Value(bucket.key_hint));
+		output.SetValue(2, count, Value::BIGINT(bucket.requests_today));
+		if (bucket.daily_quota > 0) {
+			output.SetValue(3, count, Value::BIGINT(bucket.daily_quota));
+			output.SetValue(4, count, Value::BIGINT(MaxValue<int64_t>(bucket.daily_quota - bucket.requests_today, 0)));
+		} else {
+			// Unlimited
+			output.SetValue(3, count, Value());
+			output.SetValue(4, count, Value());
+		}
+		output.SetValue(5, count, Value::BIGINT(bucket.hedged_today));
+		state.current_idx++;
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+void RegisterWebSearchQuotaFunction(ExtensionLoader &loader) {
+	TableFunction func("web_search_quota", {}, WebSearchQuotaScan, WebSearchQuotaBind, WebSearchQuotaInitGlobal);
+	loader.RegisterFunction(func);
+}
+
+} // namespace duckdb
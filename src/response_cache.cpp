@@ -0,0 +1,284 @@
+#include "response_cache.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/unordered_set.hpp"
+#include "duckdb/main/config.hpp"
+#include "miniz_wrapper.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+
+namespace duckdb {
+
+// Entry layout: fetched_at (int64, unix seconds) | body size (uint64) | key size (uint32) | key | gzip(body)
+// The key is stored so that hash collisions are detected on read
+static constexpr idx_t ENTRY_HEADER_SIZE = sizeof(int64_t) + sizeof(uint64_t) + sizeof(uint32_t);
+// Not a gzip or JSON file, despite the gzip stream inside. Entries written as .json.gz before are still evicted.
+static constexpr const char *ENTRY_EXTENSION = ".wsc";
+static constexpr const char *OLD_ENTRY_EXTENSION = ".json.gz";
+
+// Guards the directory size estimates and the set of directories being evicted - not the file system calls
+static mutex cache_lock;
+static unordered_map<string, idx_t> directory_sizes;
+static unordered_set<string> evicting_directories;
+
+// A temporary file name of its own for every write, so that processes sharing the cache directory don't write to
+// each other's temporary file: a random number per process, and a counter
+static string GetTempPath(const string &path) {
+	static const uint64_t process_id = std::random_device {}() * 0x100000000ULL + std::random_device {}();
+	static std::atomic<uint64_t> write_counter(0);
+	char suffix[64];
+	snprintf(suffix, sizeof(suffix), ".%016llx.%llu.tmp", static_cast<unsigned long long>(process_id),
+	         static_cast<unsigned long long>(write_counter++));
+	return path + suffix;
+}
+
+static int64_t CurrentEpochSeconds() {
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+	    .count();
+}
+
+ResponseCacheConfig ResponseCacheConfig::FromContext(ClientContext &context) {
+	ResponseCacheConfig config;
+	Value value;
+
+	if (context.TryGetCurrentSetting("web_search_cache_mode", value) && !value.IsNull()) {
+		auto mode = StringUtil::Lower(value.ToString());
+		if (mode == "off") {
+			config.mode = ResponseCacheMode::OFF;
+		} else if (mode == "read_through") {
+			config.mode = ResponseCacheMode::READ_THROUGH;
+		} else if (mode == "cache_only") {
+			config.mode = ResponseCacheMode::CACHE_ONLY;
+		} else if (mode == "refresh") {
+			config.mode = ResponseCacheMode::REFRESH;
+		} else {
+			throw InvalidInputException(
+			    "Unknown web_search_cache_mode '%s'. Expected: off, read_through, cache_only, refresh", mode);
+		}
+	}
+	if (config.mode == ResponseCacheMode::OFF) {
+		return config;
+	}
+
+	if (context.TryGetCurrentSetting("web_search_cache_directory", value) && !value.IsNull()) {
+		config.directory = value.ToString();
+	}
+	auto &fs = FileSystem::GetFileSystem(context);
+	config.directory = fs.ExpandPath(config.directory);
+
+	if (context.TryGetCurrentSetting("web_search_cache_ttl", value) && !value.IsNull()) {
+		config.ttl_seconds = value.GetValue<int64_t>();
+	}
+	if (context.TryGetCurrentSetting("web_search_cache_max_size", value) && !value.IsNull()) {
+		auto max_size = value.ToString();
+		config.max_size_bytes = max_size == "0" ? 0 : DBConfig::ParseMemoryLimit(max_size);
+	}
+	return config;
+}
+
+string ResponseCache::NormalizeUrl(const string &url) {
+	auto query_start = url.find('?');
+	if (query_start == string::npos) {
+		return url;
+	}
+
+	// Drop the API key (it must never end up on disk) and sort the parameters
+	vector<string> params;
+	for (auto &param : StringUtil::Split(url.substr(query_start + 1), '&')) {
+		if (param.empty() || StringUtil::StartsWith(param, "key=")) {
+			continue;
+		}
+		params.push_back(param);
+	}
+	std::sort(params.begin(), params.end());
+	return url.substr(0, query_start + 1) + StringUtil::Join(params, "&");
+}
+
+static string GetEntryPath(FileSystem &fs, const ResponseCacheConfig &config, const string &key) {
+	auto hash = Hash(key.c_str(), key.size());
+	char file_name[32];
+	snprintf(file_name, sizeof(file_name), "%016llx", static_cast<unsigned long long>(hash));
+	return fs.JoinPath(config.directory, string(file_name) + ENTRY_EXTENSION);
+}
+
+bool ResponseCache::TryGet(ClientContext &context, const ResponseCacheConfig &config, const string &url,
+                           string &body) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto key = NormalizeUrl(url);
+	auto path = GetEntryPath(fs, config, key);
+
+	try {
+		auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		if (!handle) {
+			return false;
+		}
+		auto file_size = handle->GetFileSize();
+		if (file_size < ENTRY_HEADER_SIZE) {
+			return false;
+		}
+		string contents(file_size, '\0');
+		handle->Read((void *)contents.data(), file_size, 0);
+
+		int64_t fetched_at;
+		uint64_t body_size;
+		uint32_t key_size;
+		memcpy(&fetched_at, contents.data(), sizeof(int64_t));
+		memcpy(&body_size, contents.data() + sizeof(int64_t), sizeof(uint64_t));
+		memcpy(&key_size, contents.data() + sizeof(int64_t) + sizeof(uint64_t), sizeof(uint32_t));
+		if (ENTRY_HEADER_SIZE + key_size > file_size) {
+			return false;
+		}
+		if (contents.compare(ENTRY_HEADER_SIZE, key_size, key) != 0) {
+			return false; // Hash collision
+		}
+		if (config.ttl_seconds > 0 && CurrentEpochSeconds() - fetched_at > config.ttl_seconds) {
+			return false; // Expired
+		}
+
+		auto compressed_offset = ENTRY_HEADER_SIZE + key_size;
+		body.resize(body_size);
+		MiniZStream stream;
+		stream.Decompress(contents.data() + compressed_offset, file_size - compressed_offset, (char *)body.data(),
+		                  body_size);
+		return true;
+	} catch (std::exception &) {
+		// A corrupt or concurrently replaced entry is just a miss
+		return false;
+	}
+}
+
+// Delete expired entries, then the oldest ones, until the directory is below 90% of the size limit.
+// Returns the size of the entries left.
+static idx_t EvictEntries(FileSystem &fs, const ResponseCacheConfig &config) {
+	struct CacheEntry {
+		string path;
+		int64_t fetched_at;
+		idx_t size;
+	};
+	vector<CacheEntry> entries;
+	idx_t total_size = 0;
+
+	fs.ListFiles(config.directory, [&](const string &name, bool is_directory) {
+		if (is_directory ||
+		    (!StringUtil::EndsWith(name, ENTRY_EXTENSION) && !StringUtil::EndsWith(name, OLD_ENTRY_EXTENSION))) {
+			return;
+		}
+		CacheEntry entry;
+		entry.path = fs.JoinPath(config.directory, name);
+		entry.fetched_at = 0;
+		try {
+			auto handle = fs.OpenFile(entry.path, FileFlags::FILE_FLAGS_READ);
+			entry.size = handle->GetFileSize();
+			if (entry.size >= sizeof(int64_t)) {
+				handle->Read(&entry.fetched_at, sizeof(int64_t), 0);
+			}
+		} catch (std::exception &) {
+			return;
+		}
+		total_size += entry.size;
+		entries.push_back(std::move(entry));
+	});
+
+	std::sort(entries.begin(), entries.end(),
+	          [](const CacheEntry &a, const CacheEntry &b) { return a.fetched_at < b.fetched_at; });
+
+	auto now = CurrentEpochSeconds();
+	idx_t target_size = config.max_size_bytes / 10 * 9;
+	for (auto &entry : entries) {
+		bool expired = config.ttl_seconds > 0 && now - entry.fetched_at > config.ttl_seconds;
+		if (!expired && total_size <= target_size) {
+			break;
+		}
+		try {
+			fs.RemoveFile(entry.path);
+			total_size -= entry.size;
+		} catch (std::exception &) {
+			// Removed by another process
+		}
+	}
+	return total_size;
+}
+
+void ResponseCache::Put(ClientContext &context, const ResponseCacheConfig &config, const string &url,
+                        const string &body) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	auto key = NormalizeUrl(url);
+	auto path = GetEntryPath(fs, config, key);
+
+	MiniZStream stream;
+	string compressed(stream.MaxCompressedLength(body.size()), '\0');
+	size_t compressed_size = compressed.size();
+	stream.Compress(body.data(), body.size(), (char *)compressed.data(), &compressed_size);
+
+	string entry(ENTRY_HEADER_SIZE, '\0');
+	int64_t fetched_at = CurrentEpochSeconds();
+	uint64_t body_size = body.size();
+	uint32_t key_size = static_cast<uint32_t>(key.size());
+	memcpy((char *)entry.data(), &fetched_at, sizeof(int64_t));
+	memcpy((char *)entry.data() + sizeof(int64_t), &body_size, sizeof(uint64_t));
+	memcpy((char *)entry.data() + sizeof(int64_t) + sizeof(uint64_t), &key_size, sizeof(uint32_t));
+	entry += key;
+	entry.append(compressed.data(), compressed_size);
+
+	{
+		lock_guard<mutex> guard(cache_lock);
+		if (!fs.DirectoryExists(config.directory)) {
+			fs.CreateDirectoriesRecursive(config.directory);
+		}
+	}
+
+	// Write to a temporary file and rename, so readers never see a partial entry
+	auto temp_path = GetTempPath(path);
+	try {
+		auto handle = fs.OpenFile(temp_path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		handle->Write((void *)entry.data(), entry.size());
+		handle->Close();
+		fs.MoveFile(temp_path, path);
+	} catch (std::exception &) {
+		// Eviction only sees entries: a temporary file left behind would never be removed
+		try {
+			if (fs.FileExists(temp_path)) {
+				fs.RemoveFile(temp_path);
+			}
+		} catch (std::exception &) {
+		}
+		throw;
+	}
+
+	if (config.max_size_bytes == 0) {
+		return;
+	}
+	{
+		lock_guard<mutex> guard(cache_lock);
+		auto size_entry = directory_sizes.find(config.directory);
+		// Evict on the first write to this directory in this process, or once over the limit
+		if (size_entry != directory_sizes.end()) {
+			size_entry->second += entry.size();
+			if (size_entry->second <= config.max_size_bytes) {
+				return;
+			}
+		}
+		if (!evicting_directories.insert(config.directory).second) {
+			return; // Another thread is evicting it
+		}
+	}
+
+	// Listing and deleting files can take a while: other writes go on meanwhile
+	idx_t total_size;
+	try {
+		total_size = EvictEntries(fs, config);
+	} catch (std::exception &) {
+		lock_guard<mutex> guard(cache_lock);
+		evicting_directories.erase(config.directory);
+		throw;
+	}
+	lock_guard<mutex> guard(cache_lock);
+	directory_sizes[config.directory] = total_size;
+	evicting_directories.erase(config.directory);
+}
+
+} // namespace duckdb
@@ -0,0 +1,29 @@
+#include "result_cache.hpp"
+#include "response_cache.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/config.hpp"
+
+namespace duckdb {
+
+ResultCacheConfig ResultCacheConfig::FromContext(ClientContext &context) {
+	ResultCacheConfig config;
+	Value value;
+
+	if (context.TryGetCurrentSetting("web_search_result_cache_size", value) && !value.IsNull()) {
+		auto max_size = value.ToString();
+		config.max_size_bytes = max_size == "0" ? 0 : DBConfig::ParseMemoryLimit(max_size);
+	}
+	if (context.TryGetCurrentSetting("web_search_cache_ttl", value) && !value.IsNull()) {
+		config.ttl_seconds = value.GetValue<int64_t>();
+	}
+	if (context.TryGetCurrentSetting("web_search_cache_mode", value) && !value.IsNull()) {
+		config.read = !StringUtil::CIEquals(value.ToString(), "refresh");
+	}
+	return config;
+}
+
+string ResultCacheKey(const string &first_page_url, idx_t max_results, const string &mode) {
+	return ResponseCache::NormalizeUrl(first_page_url) + "#" + std::to_string(max_results) + mode;
+}
+
+} // namespace duckdb
@@ -0,0 +1,125 @@
+#include "scan_stats.hpp"
+#include "rate_limiter.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+static string FormatMicros(idx_t micros) {
+	return StringUtil::Format("%.3fs", static_cast<double>(micros) / 1000000.0);
+}
+
+void WebSearchScanStats::AddTo(InsertionOrderPreservingMap<string> &result) const {
+	result["Result Cache"] = result_cache_hit ? "hit" : "miss";
+	result["HTTP Requests"] = std::to_string(requests.load());
+	result["Retries"] = std::to_string(retries.load());
+	result["Hedged Requests"] = std::to_string(hedges.load());
+	result["Bytes Received"] = StringUtil::BytesToHumanReadableString(bytes.load());
+	result["Bytes Received (Compressed)"] = StringUtil::BytesToHumanReadableString(wire_bytes.load());
+	result["Response Cache Hits"] = std::to_string(cache_hits.load());
+	result["Coalesced Requests"] = std::to_string(coalesced.load());
+	if (key_failovers.load() > 0) {
+		result["Key Failovers"] = std::to_string(key_failovers.load());
+	}
+	result["Network Time"] = FormatMicros(network_us.load());
+	result["Parse Time"] = FormatMicros(parse_us.load());
+	if (backoff_ms.load() > 0) {
+		result["Retry Backoff"] = FormatMicros(backoff_ms.load() * 1000);
+	}
+}
+
+struct WebSearchStat {
+	string metric;
+	Value cx;
+	Value key;
+	int64_t value;
+};
+
+struct WebSearchStatsBindData : public TableFunctionData {
+	vector<WebSearchStat> stats;
+};
+
+struct WebSearchStatsGlobalState : public GlobalTableFunctionState {
+	idx_t current_idx = 0;
+};
+
+static void AddProcessStat(vector<WebSearchStat> &stats, const string &metric, const std::atomic<idx_t> &counter) {
+	stats.push_back({metric, Value(), Value(), static_cast<int64_t>(counter.load(std::memory_order_relaxed))});
+}
+
+// Only the status codes that occurred
+static void AddStatusStats(vector<WebSearchStat> &stats, const string &prefix,
+                           const std::array<std::atomic<idx_t>, WebSearchProcessStats::STATUS_SLOTS> &counters) {
+	for (idx_t status = 0; status < counters.size(); status++) {
+		auto count = counters[status].load(std::memory_order_relaxed);
+		if (count > 0) {
+			auto metric = prefix + (status == 0 ? string("network_error") : std::to_string(status));
+			stats.push_back({metric, Value(), Value(), static_cast<int64_t>(count)});
+		}
+	}
+}
+
+static unique_ptr<FunctionData> WebSearchStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"metric", "cx", "key", "value"};
+	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BIGINT};
+
+	// Snapshot at bind time, so the rows are consistent with each other
+	auto bind_data = make_uniq<WebSearchStatsBindData>();
+	auto &stats = bind_data->stats;
+	auto &process_stats = WebSearchProcessStats::Get();
+	AddProcessStat(stats, "scans", process_stats.scans);
+	AddProcessStat(stats, "requests", process_stats.requests);
+	AddProcessStat(stats, "retries", process_stats.retries);
+	AddProcessStat(stats, "hedges", process_stats.hedges);
+	AddProcessStat(stats, "coalesced", process_stats.coalesced);
+	AddProcessStat(stats, "key_failovers", process_stats.key_failovers);
+	AddProcessStat(stats, "rate_limited_scans", process_stats.rate_limited_scans);
+	AddProcessStat(stats, "backoff_ms", process_stats.backoff_ms);
+	AddProcessStat(stats, "bytes_received", process_stats.bytes);
+	AddProcessStat(stats, "bytes_received_compressed", process_stats.wire_bytes);
+	AddProcessStat(stats, "network_us", process_stats.network_us);
+	AddProcessStat(stats, "parse_us", process_stats.parse_us);
+	AddProcessStat(stats, "response_cache_hits", process_stats.response_cache_hits);
+	AddProcessStat(stats, "response_cache_misses", process_stats.response_cache_misses);
+	AddProcessStat(stats, "result_cache_hits", process_stats.result_cache_hits);
+	AddProcessStat(stats, "result_cache_misses", process_stats.result_cache_misses);
+	AddStatusStats(stats, "responses_", process_stats.responses_by_status);
+	AddStatusStats(stats, "retries_", process_stats.retries_by_status);
+
+	for (auto &usage : ApiRateLimiter::GetKeyUsage()) {
+		stats.push_back({"key_requests_today", Value(usage.cx), Value(usage.key_hint), usage.requests_today});
+		stats.push_back({"key_requests", Value(usage.cx), Value(usage.key_hint), usage.requests_total});
+		stats.push_back({"key_rate_limited", Value(usage.cx), Value(usage.key_hint), usage.rate_limited_total});
+	}
+	return std::move(bind_data);
+}
+
+static unique_ptr<GlobalTableFunctionState> WebSearchStatsInitGlobal(ClientContext &context,
+                                                                     TableFunctionInitInput &input) {
+	return make_uniq<WebSearchStatsGlobalState>();
+}
+
+static void WebSearchStatsScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<WebSearchStatsBindData>();
+	auto &state = data.global_state->Cast<WebSearchStatsGlobalState>();
+
+	idx_t count = 0;
+	while (count < STANDARD_VECTOR_SIZE && state.current_idx < bind_data.stats.size()) {
+		auto &stat = bind_data.stats[state.current_idx];
+		output.SetValue(0, count, Value(stat.metric));
+		output.SetValue(1, count, stat.cx);
+		output.SetValue(2, count, stat.key);
+		output.SetValue(3, count, Value::BIGINT(stat.value));
+		state.current_idx++;
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+void RegisterWebSearchStatsFunction(ExtensionLoader &loader) {
+	TableFunction func("web_search_stats", {}, WebSearchStatsScan, WebSearchStatsBind, WebSearchStatsInitGlobal);
+	loader.RegisterFunction(func);
+}
+
+} // namespace duckdb
@@ -0,0 +1,242 @@
+#include "search_engine.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/planner/operator/logical_order.hpp"
+#include "duckdb/planner/operator/logical_top_n.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+
+using namespace duckdb_yyjson;
+
+namespace duckdb {
+
+shared_ptr<SearchApiDocument> ReadSearchApiResponse(const string &response_body) {
+	yyjson_doc *doc = yyjson_read(response_body.c_str(), response_body.size(), 0);
+	if (!doc) {
+		throw IOException("Failed to parse Google Search API response as JSON");
+	}
+	// Owns the document from here on
+	auto document = make_shared_ptr<SearchApiDocument>(doc, response_body.size());
+
+	// Check for API error
+	yyjson_val *error = yyjson_obj_get(yyjson_doc_get_root(doc), "error");
+	if (error) {
+		yyjson_val *message = yyjson_obj_get(error, "message");
+		string err_msg = message && yyjson_is_str(message) ? yyjson_get_str(message) : "Unknown error";
+		throw InvalidInputException("Google Search API error: %s", err_msg);
+	}
+	return document;
+}
+
+yyjson_val *GetSearchApiItems(const SearchApiDocument &document) {
+	yyjson_val *items = yyjson_obj_get(yyjson_doc_get_root(document.doc), "items");
+	if (!items || !yyjson_is_arr(items) || yyjson_arr_size(items) == 0) {
+		return nullptr;
+	}
+	return items;
+}
+
+int GetSearchApiNextStart(const SearchApiDocument &document) {
+	yyjson_val *queries = yyjson_obj_get(yyjson_doc_get_root(document.doc), "queries");
+	if (!queries) {
+		return -1;
+	}
+	yyjson_val *next_page = yyjson_obj_get(queries, "nextPage");
+	if (!next_page || !yyjson_is_arr(next_page) || yyjson_arr_size(next_page) == 0) {
+		return -1;
+	}
+	yyjson_val *start_index = yyjson_obj_get(yyjson_arr_get_first(next_page), "startIndex");
+	if (start_index && yyjson_is_int(start_index)) {
+		return static_cast<int>(yyjson_get_int(start_index));
+	}
+	return -1;
+}
+
+// The message and first reason (errors[0].reason) of an API error response body, empty if it has none
+static void ReadSearchApiError(const HttpResponse &response, string &message, string &reason) {
+	yyjson_doc *doc = yyjson_read(response.body.c_str(), response.body.size(), 0);
+	if (!doc) {
+		return;
+	}
+	yyjson_val *error = yyjson_obj_get(yyjson_doc_get_root(doc), "error");
+	yyjson_val *message_val = yyjson_obj_get(error, "message");
+	if (message_val && yyjson_is_str(message_val)) {
+		message = yyjson_get_str(message_val);
+	}
+	yyjson_val *reason_val = yyjson_obj_get(yyjson_arr_get_first(yyjson_obj_get(error, "errors")), "reason");
+	if (reason_val && yyjson_is_str(reason_val)) {
+		reason = yyjson_get_str(reason_val);
+	}
+	yyjson_doc_free(doc);
+}
+
+// A 403 for a key out of quota - not for a configuration error such as an API that is not enabled, a referrer or
+// IP restriction or a bad cx
+static bool IsQuotaExceeded(const string &reason) {
+	return reason == "dailyLimitExceeded" || reason == "quotaExceeded";
+}
+
+bool CheckSearchApiResponse(const HttpResponse &response, idx_t results_so_far) {
+	if (response.success) {
+		return true;
+	}
+	if (response.quota_exhausted) {
+		throw InvalidInputException(response.error);
+	}
+	if (response.status_code == 429) {
+		// Rate limited - return partial results if we have any (counted in web_search_stats())
+		if (results_so_far > 0) {
+			WebSearchProcessStats::Add(WebSearchProcessStats::Get().rate_limited_scans);
+			return false;
+		}
+		throw InvalidInputException("Google Search API: Rate limit exceeded. Try again later or request higher quota.");
+	} else if (response.status_code == 401) {
+		throw InvalidInputException("Google Search API: Invalid API key");
+	} else if (response.status_code == 403) {
+		string message, reason;
+		ReadSearchApiError(response, message, reason);
+		if (IsQuotaExceeded(reason)) {
+			throw InvalidInputException("Google Search API: Quota exceeded - %s", message);
+		}
+		throw InvalidInputException("Google Search API: Access denied - %s", message.empty() ? reason : message);
+	} else if (response.status_code == 400) {
+		throw InvalidInputException("Google Search API: Invalid request - %s", response.error);
+	}
+	throw IOException("Google Search API error: %s (status %d)", response.error, response.status_code);
+}
+
+int GetKeyFailoverStatus(const HttpResponse &response) {
+	if (response.quota_exhausted) {
+		// Another request used up the local quota of the key after it was picked: like a 403, for the rest of the day
+		return 403;
+	}
+	if (response.status_code == 403) {
+		// Any other 403 is the same for every key: reported, not failed over
+		string message, reason;
+		ReadSearchApiError(response, message, reason);
+		return IsQuotaExceeded(reason) ? 403 : 0;
+	}
+	return response.status_code == 429 ? 429 : 0;
+}
+
+vector<HttpResponse> FetchAllAcrossKeys(ClientContext &context, const vector<string> &key_urls,
+                                        const vector<string> &url_suffixes, const RetryConfig &config) {
+	auto max_concurrency = GetMaxConcurrency(context);
+	vector<string> urls;
+	for (auto &suffix : url_suffixes) {
+		urls.push_back(key_urls[ApiRateLimiter::PickKey(context, key_urls)] + suffix);
+	}
+	auto responses = HttpClient::FetchAll(context, urls, config, max_concurrency);
+
+	// Each round takes at least one key out of the selection, so this ends once no other key is left
+	while (true) {
+		vector<idx_t> failed;
+		for (idx_t i = 0; i < responses.size(); i++) {
+			auto status = GetKeyFailoverStatus(responses[i]);
+			if (status != 0 && ApiRateLimiter::FailOver(context, urls[i], status, key_urls)) {
+				failed.push_back(i);
+			}
+		}
+		if (failed.empty()) {
+			return responses;
+		}
+		vector<string> retry_urls;
+		for (auto i : failed) {
+			urls[i] = key_urls[ApiRateLimiter::PickKey(context, key_urls)] + url_suffixes[i];
+			retry_urls.push_back(urls[i]);
+		}
+		WebSearchProcessStats::Add(WebSearchProcessStats::Get().key_failovers, failed.size());
+		auto retry_responses = HttpClient::FetchAll(context, retry_urls, config, max_concurrency);
+		for (idx_t j = 0; j < failed.size(); j++) {
+			responses[failed[j]] = std::move(retry_responses[j]);
+		}
+	}
+}
+
+string_t GetJsonString(yyjson_val *obj, const char *key) {
+	yyjson_val *val = yyjson_obj_get(obj, key);
+	if (val && yyjson_is_str(val)) {
+		return string_t(yyjson_get_str(val), UnsafeNumericCast<uint32_t>(yyjson_get_len(val)));
+	}
+	return string_t("", 0);
+}
+
+int GetJsonInt(yyjson_val *obj, const char *key) {
+	yyjson_val *val = yyjson_obj_get(obj, key);
+	if (val && yyjson_is_int(val)) {
+		return static_cast<int>(yyjson_get_int(val));
+	}
+	return 0;
+}
+
+string BuildSearchKeyUrl(const string &endpoint, const GoogleSearchConfig &config) {
+	string url = endpoint + "?key=";
+	AppendUrlEncoded(url, config.api_key);
+	AppendUrlParameter(url, "cx", config.cx);
+	return url;
+}
+
+vector<string> BuildSearchKeyUrls(ClientContext &context, const vector<GoogleSearchConfig> &configs) {
+	auto endpoint = GetSearchEndpoint(context);
+	vector<string> urls;
+	for (auto &config : configs) {
+		urls.push_back(BuildSearchKeyUrl(config.endpoint.empty() ? endpoint : config.endpoint, config));
+	}
+	return urls;
+}
+
+void SetSearchFilterColumn(Vector &column, const string &value) {
+	if (value.empty()) {
+		column.SetVectorType(VectorType::CONSTANT_VECTOR);
+		ConstantVector::SetNull(column, true);
+	} else {
+		column.Reference(Value(value));
+	}
+}
+
+optional_ptr<LogicalGet> MatchSearchOrderByDate(LogicalOperator &op, const string &function_name, string &sort_param) {
+	// An ORDER BY with a LIMIT is planned as a top-n
+	const vector<BoundOrderByNode> *orders;
+	if (op.type == LogicalOperatorType::LOGICAL_ORDER_BY) {
+		orders = &op.Cast<LogicalOrder>().orders;
+	} else if (op.type == LogicalOperatorType::LOGICAL_TOP_N) {
+		orders = &op.Cast<LogicalTopN>().orders;
+	} else {
+		return nullptr;
+	}
+
+	reference<LogicalOperator> child = *op.children[0];
+	while (child.get().type == LogicalOperatorType::LOGICAL_PROJECTION) {
+		child = *child.get().children[0];
+	}
+	if (child.get().type != LogicalOperatorType::LOGICAL_GET) {
+		return nullptr;
+	}
+	auto &get = child.get().Cast<LogicalGet>();
+	if (get.function.name != function_name) {
+		return nullptr;
+	}
+
+	// A single column reference
+	if (orders->size() != 1 || (*orders)[0].expression->type != ExpressionType::BOUND_COLUMN_REF) {
+		return nullptr;
+	}
+	auto &order_node = (*orders)[0];
+	auto &col_ref = order_node.expression->Cast<BoundColumnRefExpression>();
+
+	// With projection pushdown the binding indexes the projected columns
+	auto &column_ids = get.GetColumnIds();
+	idx_t col_idx = col_ref.binding.column_index;
+	if (col_idx >= column_ids.size() || column_ids[col_idx].GetPrimaryIndex() >= get.names.size()) {
+		return nullptr;
+	}
+	if (get.names[column_ids[col_idx].GetPrimaryIndex()] != "date") {
+		return nullptr; // Column not supported for ORDER BY pushdown
+	}
+
+	// Google's date sort (estimated page date)
+	// See: https://developers.google.com/custom-search/docs/structured_search
+	sort_param = order_node.type == OrderType::DESCENDING ? "date:d" : "date:a";
+	return &get;
+}
+
+} // namespace duckdb
@@ -0,0 +1,95 @@
+#include "search_plan.hpp"
+#include "search_scheduler.hpp"
+
+namespace duckdb {
+
+string SearchSiteClause(const vector<string> &sites) {
+	if (sites.empty()) {
+		return string();
+	}
+	if (sites.size() == 1) {
+		return " site:" + sites[0];
+	}
+	string clause = " (";
+	for (idx_t i = 0; i < sites.size(); i++) {
+		if (i > 0) {
+			clause += " OR ";
+		}
+		clause += "site:" + sites[i];
+	}
+	clause += ")";
+	return clause;
+}
+
+string SearchSitePlan::ToString() const {
+	string result = std::to_string(QueryCount()) + (QueryCount() == 1 ? " query" : " queries");
+	if (groups.empty()) {
+		return result;
+	}
+	result += ":";
+	for (idx_t i = 0; i < groups.size(); i++) {
+		result += i > 0 ? ", " : " ";
+		result += UseSiteSearch(i) ? groups[i][0] : SearchSiteClause(groups[i]).substr(1);
+	}
+	return result;
+}
+
+// Split sites round-robin into group_count groups. Returns false if a group's q would be too long.
+static bool GroupSearchSites(const vector<string> &sites, idx_t group_count, idx_t base_query_length,
+                             vector<vector<string>> &groups) {
+	groups.assign(group_count, vector<string>());
+	for (idx_t i = 0; i < sites.size(); i++) {
+		groups[i % group_count].push_back(sites[i]);
+	}
+	for (idx_t i = 0; i < group_count; i++) {
+		// A lone site of a multi-query plan goes into siteSearch, not q
+		if (group_count > 1 && groups[i].size() == 1) {
+			continue;
+		}
+		if (base_query_length + SearchSiteClause(groups[i]).size() > SEARCH_MAX_QUERY_LENGTH) {
+			return false;
+		}
+	}
+	return true;
+}
+
+SearchSitePlan PlanSearchSites(const vector<string> &sites, idx_t max_results, idx_t base_query_length) {
+	static constexpr idx_t MAX_RESULTS_PER_QUERY = SEARCH_RESULTS_PER_PAGE * SEARCH_MAX_PAGES;
+
+	SearchSitePlan best;
+	best.estimated_results = MinValue<idx_t>(max_results, MAX_RESULTS_PER_QUERY);
+	best.estimated_requests = (best.estimated_results + SEARCH_RESULTS_PER_PAGE - 1) / SEARCH_RESULTS_PER_PAGE;
+	if (sites.empty()) {
+		return best;
+	}
+
+	bool found = false;
+	vector<vector<string>> groups;
+	for (idx_t group_count = 1; group_count <= sites.size(); group_count++) {
+		if (!GroupSearchSites(sites, group_count, base_query_length, groups)) {
+			continue; // Too long - more (shorter) groups are needed
+		}
+		// Assume every query returns full pages; each query costs at least its first request even if it is empty
+		auto results = MinValue<idx_t>(max_results, group_count * MAX_RESULTS_PER_QUERY);
+		auto requests = MaxValue<idx_t>(group_count, (results + SEARCH_RESULTS_PER_PAGE - 1) / SEARCH_RESULTS_PER_PAGE);
+		// Reaching the LIMIT first, then fewest requests; ties go to fewer queries
+		if (found && (results < best.estimated_results ||
+		              (results == best.estimated_results && requests >= best.estimated_requests))) {
+			continue;
+		}
+		best.groups = groups;
+		best.estimated_results = results;
+		best.estimated_requests = requests;
+		found = true;
+	}
+	if (!found) {
+		// Even one site per query is too long - let the API report it
+		GroupSearchSites(sites, sites.size(), base_query_length, best.groups);
+		best.estimated_results = MinValue<idx_t>(max_results, sites.size() * MAX_RESULTS_PER_QUERY);
+		best.estimated_requests = MaxValue<idx_t>(
+		    sites.size(), (best.estimated_results + SEARCH_RESULTS_PER_PAGE - 1) / SEARCH_RESULTS_PER_PAGE);
+	}
+	return best;
+}
+
+} // namespace duckdb
@@ -0,0 +1,105 @@
+#include "search_scheduler.hpp"
+
+namespace duckdb {
+
+SearchPageScheduler::SearchPageScheduler(idx_t stream_count_p, idx_t max_results_p, idx_t window_p)
+    : stream_count(MaxValue<idx_t>(stream_count_p, 1)), max_results(max_results_p), window(window_p),
+      stream_exhausted(stream_count, false) {
+}
+
+bool SearchPageScheduler::CanClaim() const {
+	if (stopped || (window > 0 && in_flight >= window)) {
+		return false;
+	}
+	// Assume every page in flight comes back full
+	return result_count + in_flight * SEARCH_RESULTS_PER_PAGE < max_results;
+}
+
+bool SearchPageScheduler::Claim(SearchPageUnit &unit) {
+	lock_guard<mutex> guard(lock);
+	if (!CanClaim()) {
+		return false;
+	}
+	for (; next_ordinal < stream_count * SEARCH_MAX_PAGES; next_ordinal++) {
+		auto stream = next_ordinal % stream_count;
+		if (stream_exhausted[stream]) {
+			continue;
+		}
+		unit.ordinal = next_ordinal++;
+		unit.stream = stream;
+		unit.page = unit.ordinal / stream_count;
+		in_flight++;
+		return true;
+	}
+	return false;
+}
+
+void SearchPageScheduler::Complete(const SearchPageUnit &unit, idx_t page_results, bool last_page) {
+	lock_guard<mutex> guard(lock);
+	D_ASSERT(in_flight > 0);
+	in_flight--;
+	completed_pages++;
+	result_count += page_results;
+	if (last_page) {
+		stream_exhausted[unit.stream] = true;
+	}
+}
+
+void SearchPageScheduler::Stop() {
+	lock_guard<mutex> guard(lock);
+	stopped = true;
+}
+
+bool SearchPageScheduler::Finished() {
+	lock_guard<mutex> guard(lock);
+	return IsFinished();
+}
+
+bool SearchPageScheduler::IsFinished() const {
+	if (in_flight > 0) {
+		return false;
+	}
+	if (!CanClaim()) {
+		return true;
+	}
+	for (auto ordinal = next_ordinal; ordinal < stream_count * SEARCH_MAX_PAGES; ordinal++) {
+		if (!stream_exhausted[ordinal % stream_count]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SearchPageScheduler::Stopped() {
+	lock_guard<mutex> guard(lock);
+	return stopped;
+}
+
+idx_t SearchPageScheduler::ResultCount() {
+	lock_guard<mutex> guard(lock);
+	return result_count;
+}
+
+idx_t SearchPageScheduler::MaxPages() const {
+	auto pages = (max_results + SEARCH_RESULTS_PER_PAGE - 1) / SEARCH_RESULTS_PER_PAGE;
+	return MaxValue<idx_t>(MinValue<idx_t>(pages, stream_count * SEARCH_MAX_PAGES), 1);
+}
+
+double SearchPageScheduler::Progress() const {
+	lock_guard<mutex> guard(lock);
+	if (IsFinished()) {
+		return 100.0;
+	}
+	// Streams may run out early, so this is a lower bound
+	return MinValue<double>(100.0, 100.0 * static_cast<double>(completed_pages) / static_cast<double>(MaxPages()));
+}
+
+idx_t GetSearchPageWindow(idx_t prefetch_pages, bool limit_pushed) {
+	if (prefetch_pages > 0) {
+		return prefetch_pages;
+	}
+	// Automatic: with a pushed down LIMIT the page count is known up front, otherwise fetch one page at a time
+	return limit_pushed ? 0 : 1;
+}
+
+} // namespace duckdb
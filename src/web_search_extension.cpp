@@ -5,6 +5,10 @@
 #include "google_search_function.hpp"
 #include "google_image_search_function.hpp"
 #include "annotation_copy.hpp"
+#include "annotation_reader.hpp"
+#include "web_search_settings.hpp"
+#include "rate_limiter.hpp"
+#include "scan_stats.hpp"
 #include "duckdb.hpp"
 #include "duckdb/main/config.hpp"
 #include "duckdb/main/extension_helper.hpp"
@@ -17,6 +21,7 @@ static void WebSearchOptimizer(OptimizerExtensionInput &input, unique_ptr<Logica
 	OptimizeGoogleSearchLimitPushdown(plan);
 	OptimizeGoogleSearchOrderByPushdown(plan);
 	OptimizeGoogleImageSearchLimitPushdown(plan);
+	OptimizeGoogleImageSearchOrderByPushdown(plan);
 }
 
 static void LoadInternal(ExtensionLoader &loader) {
@@ -24,6 +29,12 @@ static void LoadInternal(ExtensionLoader &loader) {
 	auto &db = loader.GetDatabaseInstance();
 	ExtensionHelper::TryAutoLoadExtension(db, "json");
 
+	// Autoload httpfs (provides the HTTPS-capable HTTPUtil used by HttpClient)
+	ExtensionHelper::TryAutoLoadExtension(db, "httpfs");
+
+	// Register web_search_* settings
+	RegisterWebSearchSettings(loader);
+
 	// Register google_search secret type
 	RegisterGoogleSearchSecretType(loader);
 
@@ -33,9 +44,18 @@ static void LoadInternal(ExtensionLoader &loader) {
 	// Register google_image_search() table function
 	RegisterGoogleImageSearchFunction(loader);
 
+	// Register web_search_quota() table function
+	RegisterWebSearchQuotaFunction(loader);
+
+	// Register web_search_stats() table function
+	RegisterWebSearchStatsFunction(loader);
+
 	// Register google_pse_annotation COPY function
 	RegisterAnnotationCopyFunction(loader);
 
+	// Register read_pse_annotations() table function
+	RegisterReadPseAnnotationsFunction(loader);
+
 	// Register optimizer extension for LIMIT pushdown
 	OptimizerExtension optimizer;
 	optimizer.optimize_function = WebSearchOptimizer;
@@ -0,0 +1,128 @@
+#include "web_search_settings.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/config.hpp"
+
+namespace duckdb {
+
+static constexpr int64_t DEFAULT_MAX_CONCURRENCY = 8;
+static constexpr int64_t DEFAULT_CACHE_TTL_SECONDS = 24 * 60 * 60;
+static constexpr const char *DEFAULT_ENDPOINT = "https://www.googleapis.com/customsearch/v1";
+
+// Reject unknown cache modes at SET time rather than at the next query
+static void ValidateCacheMode(ClientContext &context, SetScope scope, Value &parameter) {
+	auto mode = StringUtil::Lower(parameter.ToString());
+	if (mode != "off" && mode != "read_through" && mode != "cache_only" && mode != "refresh") {
+		throw InvalidInputException(
+		    "Unknown web_search_cache_mode '%s'. Expected: off, read_through, cache_only, refresh", mode);
+	}
+	parameter = Value(mode);
+}
+
+static void ValidateNonNegative(ClientContext &context, SetScope scope, Value &parameter) {
+	if (parameter.GetValue<double>() < 0) {
+		throw InvalidInputException("Value must be >= 0, got %s", parameter.ToString());
+	}
+}
+
+static void ValidatePercentile(ClientContext &context, SetScope scope, Value &parameter) {
+	auto percentile = parameter.GetValue<double>();
+	if (percentile < 0 || percentile >= 100) {
+		throw InvalidInputException("web_search_hedge_percentile must be >= 0 and < 100");
+	}
+}
+
+static void ValidateEndpoint(ClientContext &context, SetScope scope, Value &parameter) {
+	ValidateSearchEndpoint(parameter.ToString(), "web_search_endpoint");
+}
+
+static void ValidateCacheSize(ClientContext &context, SetScope scope, Value &parameter) {
+	// Throws on malformed sizes
+	auto max_size = parameter.ToString();
+	if (max_size != "0") {
+		DBConfig::ParseMemoryLimit(max_size);
+	}
+}
+
+void RegisterWebSearchSettings(ExtensionLoader &loader) {
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+
+	config.AddExtensionOption("web_search_endpoint",
+	                          "Custom Search API endpoint, e.g. a proxy or a local mock server for benchmarks",
+	                          LogicalType::VARCHAR, Value(DEFAULT_ENDPOINT), ValidateEndpoint);
+
+	config.AddExtensionOption("web_search_max_concurrency",
+	                          "Maximum number of Custom Search API requests a single scan keeps in flight",
+	                          LogicalType::BIGINT, Value::BIGINT(DEFAULT_MAX_CONCURRENCY));
+
+	config.AddExtensionOption("web_search_max_qps",
+	                          "Requests per second per API key, shared by all connections (0 = unlimited)",
+	                          LogicalType::DOUBLE, Value::DOUBLE(0));
+	config.AddExtensionOption("web_search_daily_quota",
+	                          "Requests per API key per UTC day before queries fail (0 = unlimited)",
+	                          LogicalType::BIGINT, Value::BIGINT(0));
+
+	// Defaults of RetryConfig
+	config.AddExtensionOption("web_search_max_retries", "Retries of a failed (429, 5xx, network error) API request",
+	                          LogicalType::BIGINT, Value::BIGINT(3), ValidateNonNegative);
+	config.AddExtensionOption("web_search_initial_backoff_ms", "Backoff before the first retry, in milliseconds",
+	                          LogicalType::BIGINT, Value::BIGINT(100), ValidateNonNegative);
+	config.AddExtensionOption("web_search_backoff_multiplier", "Factor the backoff grows by with every retry",
+	                          LogicalType::DOUBLE, Value::DOUBLE(2.0), ValidateNonNegative);
+	config.AddExtensionOption("web_search_max_backoff_ms",
+	                          "Upper bound of the backoff between retries, in milliseconds", LogicalType::BIGINT,
+	                          Value::BIGINT(10000), ValidateNonNegative);
+
+	config.AddExtensionOption("web_search_hedge_percentile",
+	                          "Send a duplicate of a request that is slower than this percentile of recent response "
+	                          "times, e.g. 95 (0 = no hedging)",
+	                          LogicalType::DOUBLE, Value::DOUBLE(0), ValidatePercentile);
+	config.AddExtensionOption(
+	    "web_search_hedge_daily_quota",
+	    "Hedged duplicate requests per API key per UTC day (they also count towards web_search_daily_quota)",
+	    LogicalType::BIGINT, Value::BIGINT(100), ValidateNonNegative);
+
+	config.AddExtensionOption("web_search_cache_mode",
+	                          "On-disk API response cache: off, read_through, cache_only or refresh",
+	                          LogicalType::VARCHAR, Value("off"), ValidateCacheMode);
+	config.AddExtensionOption("web_search_cache_directory", "Directory of the on-disk API response cache",
+	                          LogicalType::VARCHAR, Value("~/.duckdb/web_search_cache"));
+	config.AddExtensionOption("web_search_cache_ttl",
+	                          "Seconds cached responses and results stay valid (0 = never expire)", LogicalType::BIGINT,
+	                          Value::BIGINT(DEFAULT_CACHE_TTL_SECONDS));
+	config.AddExtensionOption("web_search_cache_max_size",
+	                          "Size limit of the API response cache directory, e.g. '256MB' (0 = unlimited)",
+	                          LogicalType::VARCHAR, Value("256MB"), ValidateCacheSize);
+	config.AddExtensionOption("web_search_result_cache_size",
+	                          "Memory budget of the process-wide cache of parsed search results (0 = disabled)",
+	                          LogicalType::VARCHAR, Value("64MB"), ValidateCacheSize);
+}
+
+idx_t GetMaxConcurrency(ClientContext &context) {
+	Value value;
+	if (context.TryGetCurrentSetting("web_search_max_concurrency", value) && !value.IsNull()) {
+		auto max_concurrency = value.GetValue<int64_t>();
+		if (max_concurrency > 0) {
+			return static_cast<idx_t>(max_concurrency);
+		}
+	}
+	return 1;
+}
+
+void ValidateSearchEndpoint(const string &endpoint, const char *name) {
+	if (!StringUtil::StartsWith(endpoint, "https://") && !StringUtil::StartsWith(endpoint, "http://")) {
+		throw InvalidInputException("%s must be an http:// or https:// URL, got '%s'", name, endpoint);
+	}
+	if (endpoint.find('?') != string::npos) {
+		throw InvalidInputException("%s must not contain query parameters", name);
+	}
+}
+
+string GetSearchEndpoint(ClientContext &context) {
+	Value value;
+	if (context.TryGetCurrentSetting("web_search_endpoint", value) && !value.IsNull()) {
+		return value.ToString();
+	}
+	return DEFAULT_ENDPOINT;
+}
+
+} // namespace duckdb